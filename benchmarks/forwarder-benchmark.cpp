@@ -0,0 +1,381 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// forwarder-benchmark.cpp
+//
+// Drives a single NFD Forwarder with in-memory faces and pre-generated packets, without
+// nodes, channels, NetDevices or applications. Only the forwarder's own timers (PIT
+// expiry, straggler timers, Dead Nonce List) are in the ns-3 event queue, which is run
+// up to the arrival time of the next packet. Reports packets/s, ns/packet and heap
+// allocations/packet of the forwarding pipelines and the strategy. Time and allocations
+// are taken around the injections and the timer runs only, the Stop event scheduled
+// before each run is not counted. With --appPackets, the heap allocations of creating the
+// packets of an application are measured as well, with and without the packet pool.
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "../extensions/apps/data-template.hpp"
+#include "../extensions/apps/packet-pool.hpp"
+#include "../extensions/utils/in-memory-face.hpp"
+#include "../extensions/utils/parameterconfiguration.h"
+
+#include "fw/forwarder.hpp"
+#include "fw/push-counters.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+// heap allocations of the whole program, only read around the measured calls
+static uint64_t g_nAllocations = 0;
+
+void*
+operator new(std::size_t size)
+{
+  ++g_nAllocations;
+  void* p = std::malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void
+operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+namespace ns3 {
+
+/**
+ * A packet arriving on a face, either an Interest or a Data
+ */
+struct Step
+{
+  int64_t time; ///< nanoseconds
+  ndn::InMemoryLinkService* face;
+  shared_ptr<ndn::Interest> interest;
+  shared_ptr<ndn::Data> data;
+};
+
+int
+main(int argc, char* argv[])
+{
+  std::string workload = "push";
+  std::string strategy = "multicast";
+  uint32_t flows = 10;
+  uint32_t fanIn = 3;
+  uint32_t fanOut = 2;
+  uint32_t packets = 10000;
+  double frequency = 50;
+  double probeFrequency = 10;
+  double refreshInterval = 1.5;
+  uint32_t bitvectorLength = 8;
+  uint32_t reorder = 0;
+  uint32_t payloadSize = 160;
+  uint32_t seed = 1;
+  uint32_t appPackets = 0;
+  double appFrequency = 100;
+
+  CommandLine cmd;
+  cmd.AddValue("workload", "push, refresh (push with refreshed PIs), probe or mixed", workload);
+  cmd.AddValue("strategy", "Forwarding strategy, e.g. multicast or lowest-cost", strategy);
+  cmd.AddValue("flows", "Number of push flows", flows);
+  cmd.AddValue("fanIn", "Upstream faces, every push Data arrives on each of them", fanIn);
+  cmd.AddValue("fanOut", "Downstream faces, each sends a PI per flow", fanOut);
+  cmd.AddValue("packets", "Push Data per flow", packets);
+  cmd.AddValue("frequency", "Push Data per second and flow", frequency);
+  cmd.AddValue("probeFrequency", "Probes per second and flow", probeFrequency);
+  cmd.AddValue("refreshInterval", "Seconds between refreshed PIs", refreshInterval);
+  cmd.AddValue("bitvectorLength", "Length of the loop detection bitvector", bitvectorLength);
+  cmd.AddValue("reorder", "Shuffle the sequence numbers within windows of this size", reorder);
+  cmd.AddValue("payloadSize", "Content size of the Data packets", payloadSize);
+  cmd.AddValue("seed", "Seed of the nonces and the reordering", seed);
+  cmd.AddValue("appPackets", "Also measure the allocations of creating this many application "
+               "Data and Interests, with and without the packet pool (0=off)", appPackets);
+  cmd.AddValue("appFrequency", "Packets per second of an application for the per-second "
+               "allocations of --appPackets", appFrequency);
+  cmd.Parse(argc, argv);
+
+  bool hasPush = workload == "push" || workload == "refresh" || workload == "mixed";
+  bool hasRefresh = workload == "refresh" || workload == "mixed";
+  bool hasProbes = workload == "probe" || workload == "mixed";
+  if (!hasPush && !hasProbes) {
+    NS_FATAL_ERROR("Unknown workload " << workload);
+  }
+  if (fanIn == 0 || fanOut == 0) {
+    NS_FATAL_ERROR("fanIn and fanOut have to be at least 1");
+  }
+
+  // installs the ns-3 backed clocks of ndn-cxx, no node gets a stack
+  ndn::StackHelper ndnHelper;
+  ParameterConfiguration::getInstance()->setParameter("bitector_length", bitvectorLength);
+
+  std::unique_ptr<nfd::Forwarder> forwarder(new nfd::Forwarder());
+  if (!forwarder->getStrategyChoice().insert("/", "/localhost/nfd/strategy/" + strategy)) {
+    NS_FATAL_ERROR("Unknown strategy " << strategy);
+  }
+
+  std::vector<ndn::InMemoryLinkService*> upstreams;
+  std::vector<ndn::InMemoryLinkService*> downstreams;
+  for (uint32_t i = 0; i < fanIn; i++) {
+    upstreams.push_back(ndn::InMemoryLinkService::AddFace(*forwarder,
+                                                          "benchmark://upstream" + std::to_string(i)));
+    forwarder->getFib().insert("/benchmark").first->addNextHop(upstreams[i]->getForwarderFace(), i + 1);
+  }
+  for (uint32_t i = 0; i < fanOut; i++) {
+    downstreams.push_back(ndn::InMemoryLinkService::AddFace(*forwarder,
+                                                            "benchmark://downstream" + std::to_string(i)));
+  }
+
+  // pre-generate all packets, so that the replay only measures the forwarder
+  std::mt19937 rng(seed);
+  std::vector<Step> steps;
+  int64_t period = static_cast<int64_t>(1e9 / frequency);
+  int64_t duration = packets * period;
+  int64_t pathSpread = 1000000; // the copies of a push Data arrive 1 ms apart
+
+  ndn::DataTemplate pushTemplate;
+  pushTemplate.prepare("push", 0, ndn::time::milliseconds(0), ndn::Name(), 0);
+  ndn::DataTemplate probeTemplate;
+  probeTemplate.prepare("", 0, ndn::time::milliseconds(0), ndn::Name(), 0);
+  const ::ndn::Block& payload = ndn::PacketPool::getVirtualPayload(payloadSize);
+
+  auto makeInterest = [&rng] (const ndn::Name& name, ndn::time::milliseconds lifetime) {
+    auto interest = std::make_shared<ndn::Interest>(name);
+    interest->setNonce(rng());
+    interest->setInterestLifetime(lifetime);
+    return interest;
+  };
+
+  for (uint32_t flow = 0; flow < flows; flow++) {
+    ndn::Name flowPrefix("/benchmark/flow" + std::to_string(flow));
+
+    if (hasPush) {
+      ndn::Name piName = ndn::Name(flowPrefix).append("push");
+      ndn::time::milliseconds lifetime(hasRefresh ? static_cast<int64_t>(3000 * refreshInterval)
+                                                  : duration / 1000000 + 1000);
+      for (ndn::InMemoryLinkService* downstream : downstreams) {
+        auto interest = makeInterest(piName, lifetime);
+        interest->setPush(true);
+        steps.push_back({flow, downstream, interest, nullptr});
+
+        for (double t = refreshInterval; hasRefresh && t * 1e9 < duration; t += refreshInterval) {
+          auto refresh = makeInterest(piName, lifetime);
+          refresh->setPushRefresh(true);
+          steps.push_back({static_cast<int64_t>(t * 1e9) + flow, downstream, refresh, nullptr});
+        }
+      }
+
+      std::vector<uint64_t> seqs(packets);
+      for (uint32_t i = 0; i < packets; i++) {
+        seqs[i] = i;
+      }
+      for (uint32_t i = 0; reorder > 1 && i < packets; i += reorder) {
+        std::shuffle(seqs.begin() + i, seqs.begin() + std::min(i + reorder, packets), rng);
+      }
+      for (uint32_t i = 0; i < packets; i++) {
+        auto data = std::make_shared<ndn::Data>();
+        pushTemplate.encode(*data, ndn::Name(piName).appendSequenceNumber(seqs[i]), payload);
+        // the same packet arrives on every path, all but the first copy are loops
+        for (uint32_t u = 0; u < fanIn; u++) {
+          steps.push_back({(i + 1) * period + u * pathSpread + flow, upstreams[u], nullptr, data});
+        }
+      }
+    }
+
+    if (hasProbes && probeFrequency > 0) {
+      int64_t probePeriod = static_cast<int64_t>(1e9 / probeFrequency);
+      int64_t rtt = 10000000;
+      for (int64_t t = 0, seq = 0; t < duration; t += probePeriod, seq++) {
+        ndn::Name probeName(flowPrefix.toUri() + ParameterConfiguration::getInstance()->PROBE_SUFFIX);
+        probeName.appendSequenceNumber(seq);
+        auto probe = makeInterest(probeName, ndn::time::milliseconds(2000));
+        probe->setPush(false);
+        steps.push_back({t + flow, downstreams[0], probe, nullptr});
+
+        auto data = std::make_shared<ndn::Data>();
+        probeTemplate.encode(*data, probeName, payload);
+        steps.push_back({t + rtt + flow, upstreams[seq % fanIn], nullptr, data});
+      }
+    }
+  }
+
+  std::stable_sort(steps.begin(), steps.end(),
+                   [] (const Step& a, const Step& b) { return a.time < b.time; });
+
+  std::cout << "Workload: " << workload << ", strategy " << strategy << ", " << flows
+            << " flows, fan-in " << fanIn << ", fan-out " << fanOut << ", bitvector "
+            << bitvectorLength << ", reorder " << reorder << std::endl;
+
+  // only the forwarder is measured: the packet injections and the timers run up to each
+  // arrival, but not the Stop event the harness schedules for every step
+  uint64_t nAllocations = 0;
+  std::chrono::nanoseconds wallTime(0);
+  auto replayStart = std::chrono::steady_clock::now();
+
+  for (const Step& step : steps) {
+    int64_t now = Simulator::Now().GetNanoSeconds();
+    if (step.time > now) {
+      // expire the forwarder's timers up to the arrival of the packet
+      Simulator::Stop(NanoSeconds(step.time - now));
+      uint64_t nAllocationsBefore = g_nAllocations;
+      auto start = std::chrono::steady_clock::now();
+      Simulator::Run();
+      wallTime += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start);
+      nAllocations += g_nAllocations - nAllocationsBefore;
+    }
+
+    uint64_t nAllocationsBefore = g_nAllocations;
+    auto start = std::chrono::steady_clock::now();
+    if (step.interest != nullptr) {
+      step.face->injectInterest(*step.interest);
+    }
+    else {
+      step.face->injectData(*step.data);
+    }
+    wallTime += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  std::chrono::steady_clock::now() - start);
+    nAllocations += g_nAllocations - nAllocationsBefore;
+  }
+
+  auto replayTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - replayStart);
+
+  uint64_t nSentInterests = 0;
+  uint64_t nSentData = 0;
+  uint64_t nSentNacks = 0;
+  for (ndn::InMemoryLinkService* face : upstreams) {
+    nSentInterests += face->nSentInterests;
+  }
+  for (ndn::InMemoryLinkService* face : downstreams) {
+    nSentData += face->nSentData;
+    nSentNacks += face->nSentNacks;
+  }
+
+  double nPackets = steps.size();
+  const nfd::ForwarderCounters& counters = forwarder->getCounters();
+  const nfd::fw::PushCounters& pushCounters = forwarder->getPushCounters();
+
+  std::cout << "Packets: " << steps.size() << " in " << wallTime.count() / 1e6
+            << " ms forwarder time (" << replayTime.count() / 1e6 << " ms with the harness)"
+            << std::endl;
+  std::cout << "Packets/s: " << (wallTime.count() == 0 ? 0.0 : nPackets * 1e9 / wallTime.count())
+            << std::endl;
+  std::cout << "ns/packet: " << wallTime.count() / nPackets << std::endl;
+  std::cout << "Allocations/packet: " << nAllocations / nPackets << std::endl;
+  std::cout << "InInterests: " << counters.nInInterests << ", InData: " << counters.nInData
+            << std::endl;
+  std::cout << "OutInterests: " << nSentInterests << ", OutData: " << nSentData
+            << ", OutNacks: " << nSentNacks << std::endl;
+  std::cout << "LoopingDrops: " << pushCounters.nLoopingDrops
+            << ", DuplicateDeliveries: " << pushCounters.nDuplicateDeliveries << std::endl;
+  std::cout << "PIT entries: " << forwarder->getPit().size() << std::endl;
+
+  if (appPackets > 0) {
+    // every packet is released before the next one is created, as once the forwarder has
+    // sent it, so that the pool can hand out its slots again
+    auto measure = [appPackets] (const std::function<void(uint32_t)>& create) {
+      uint64_t nAllocationsBefore = g_nAllocations;
+      for (uint32_t i = 0; i < appPackets; i++) {
+        create(i);
+      }
+      return static_cast<double>(g_nAllocations - nAllocationsBefore) / appPackets;
+    };
+
+    ndn::Name appPrefix("/benchmark/app/push");
+    ndn::PacketPool pool;
+    ::ndn::Signature signature;
+    signature.setInfo(::ndn::SignatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255)));
+    signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, 0));
+
+    // as PushProducer::SendPacket() before the pool
+    double nDataAllocations = measure([&] (uint32_t i) {
+      auto data = std::make_shared<ndn::Data>();
+      data->setName(ndn::Name(appPrefix).appendSequenceNumber(i));
+      data->setPush(true);
+      data->setContent(std::make_shared< ::ndn::Buffer>(payloadSize));
+      data->setSignature(signature);
+      data->wireEncode();
+    });
+    double nPooledDataAllocations = measure([&] (uint32_t i) {
+      auto data = pool.acquireData();
+      data->setName(ndn::Name(appPrefix).appendSequenceNumber(i));
+      data->setPush(true);
+      data->setContent(payload);
+      data->setSignature(signature);
+      data->wireEncode();
+    });
+    double nTemplateDataAllocations = measure([&] (uint32_t i) {
+      auto data = pool.acquireData();
+      pushTemplate.encode(*data, ndn::Name(appPrefix).appendSequenceNumber(i), payload);
+    });
+
+    // as PushConsumer::SendPacket() before and with the pool
+    double nInterestAllocations = measure([&] (uint32_t i) {
+      shared_ptr<ndn::Name> name = std::make_shared<ndn::Name>(appPrefix);
+      auto interest = std::make_shared<ndn::Interest>();
+      interest->setNonce(i);
+      interest->setName(*name);
+      interest->setPush(true);
+    });
+    double nPooledInterestAllocations = measure([&] (uint32_t i) {
+      auto interest = pool.acquireInterest();
+      interest->setNonce(i);
+      interest->setName(appPrefix);
+      interest->setPush(true);
+    });
+
+    std::cout << "App allocations/Data: " << nDataAllocations << " without pool, "
+              << nPooledDataAllocations << " with pool, " << nTemplateDataAllocations
+              << " with pool and template" << std::endl;
+    std::cout << "App allocations/Interest: " << nInterestAllocations << " without pool, "
+              << nPooledInterestAllocations << " with pool" << std::endl;
+    std::cout << "App allocations/s at " << appFrequency << " Data/s: "
+              << nDataAllocations * appFrequency << " without pool, "
+              << nPooledDataAllocations * appFrequency << " with pool, "
+              << nTemplateDataAllocations * appFrequency << " with pool and template" << std::endl;
+    std::cout << "App allocations/s at " << appFrequency << " Interests/s: "
+              << nInterestAllocations * appFrequency << " without pool, "
+              << nPooledInterestAllocations * appFrequency << " with pool" << std::endl;
+  }
+
+  steps.clear();
+  forwarder.reset();
+  Simulator::Destroy();
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -0,0 +1,116 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// trace-replay.cpp
+//
+// Replays the packets one node received in a run (packet-trace.txt of L3PacketTracer, or
+// its binary version) into a stand-alone forwarder with the same strategy, e.g. to
+// profile a single core router of a large topology or to reproduce a loop.
+
+#include "ns3/core-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "../extensions/utils/parameterconfiguration.h"
+#include "../extensions/utils/trace-replay.hpp"
+
+#include "fw/forwarder.hpp"
+
+#include <iostream>
+#include <memory>
+
+namespace ns3 {
+
+int
+main(int argc, char* argv[])
+{
+  std::string trace = "packet-trace.txt";
+  std::string node;
+  std::string strategy = "multicast";
+  uint32_t bitvectorLength = 8;
+  double speed = 0;
+  uint32_t routePrefixLength = 2;
+  Time lifetime = Seconds(2);
+  bool useRefreshPi = false;
+  std::string nackReason = "NoRoute";
+  uint32_t seed = 1;
+
+  CommandLine cmd;
+  cmd.AddValue("trace", "Packet trace, TSV or binary", trace);
+  cmd.AddValue("node", "Node whose incoming packets are replayed", node);
+  cmd.AddValue("strategy", "Forwarding strategy, e.g. multicast or lowest-cost", strategy);
+  cmd.AddValue("bitvectorLength", "Length of the loop detection bitvector", bitvectorLength);
+  cmd.AddValue("speed", "Simulated seconds per wall clock second, 0 for maximal speed", speed);
+  cmd.AddValue("routePrefixLength", "Name components of the routes taken from the trace",
+               routePrefixLength);
+  cmd.AddValue("lifetime", "Lifetime of the replayed Interests", lifetime);
+  cmd.AddValue("useRefreshPi", "Replay repeated PIs of a face as RPIs", useRefreshPi);
+  cmd.AddValue("nackReason", "Reason of the replayed Nacks: NoRoute, Duplicate or Congestion",
+               nackReason);
+  cmd.AddValue("seed", "Seed of the Interest nonces", seed);
+  cmd.Parse(argc, argv);
+
+  if (node.empty()) {
+    NS_FATAL_ERROR("--node is required");
+  }
+
+  ndn::lp::NackReason reason = ndn::lp::NackReason::NO_ROUTE;
+  if (nackReason == "Duplicate") {
+    reason = ndn::lp::NackReason::DUPLICATE;
+  }
+  else if (nackReason == "Congestion") {
+    reason = ndn::lp::NackReason::CONGESTION;
+  }
+  else if (nackReason != "NoRoute") {
+    NS_FATAL_ERROR("Unknown Nack reason " << nackReason);
+  }
+
+  // installs the ns-3 backed clocks of ndn-cxx, no node gets a stack
+  ndn::StackHelper ndnHelper;
+  ParameterConfiguration::getInstance()->setParameter("bitector_length", bitvectorLength);
+
+  std::unique_ptr<nfd::Forwarder> forwarder(new nfd::Forwarder());
+  if (!forwarder->getStrategyChoice().insert("/", "/localhost/nfd/strategy/" + strategy)) {
+    NS_FATAL_ERROR("Unknown strategy " << strategy);
+  }
+
+  {
+    ndn::TraceReplay replay(*forwarder);
+    replay.setRoutePrefixLength(routePrefixLength);
+    replay.setInterestLifetime(ndn::time::milliseconds(lifetime.GetMilliSeconds()));
+    replay.setUseRefreshPi(useRefreshPi);
+    replay.setNackReason(reason);
+    replay.setSeed(seed);
+    replay.load(trace, node);
+    replay.run(speed);
+    replay.printSummary(std::cout);
+  }
+
+  forwarder.reset();
+  Simulator::Destroy();
+
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -0,0 +1,166 @@
+#!/usr/bin/env python
+# -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+
+# Converts a binary packet trace (L3PacketTracer::InstallAllBinary) to the tab-separated
+# format written by L3PacketTracer::InstallAll, which is read by the R scripts in graphs/.
+#
+# Columnar traces (ColumnarWriter, *.col) are converted to TSV as well. read_columnar()
+# can be imported to get the columns as lists without going through text.
+
+import argparse
+import struct
+import sys
+
+MAGIC = b'NDNT'
+VERSION = 1
+
+COLUMNAR_MAGIC = b'NDNC'
+COLUMNAR_VERSION = 1
+TYPE_INT64, TYPE_DOUBLE, TYPE_STRING = 0, 1, 2
+VARINT, DELTA_VARINT, RLE_VARINT, RAW_DOUBLE = 0, 1, 2, 3
+
+STRING = struct.Struct('<II')
+PACKET = struct.Struct('<qIIIBII')
+
+TYPES = ['InInterest', 'OutInterest', 'InData', 'OutData', 'InNack', 'OutNack']
+
+def read_exactly(f, size):
+    data = f.read(size)
+    if len(data) != size:
+        raise EOFError('truncated trace file')
+    return data
+
+def read_varint(data, pos):
+    result = 0
+    shift = 0
+    while True:
+        byte = ord(data[pos:pos + 1])
+        pos += 1
+        result |= (byte & 0x7f) << shift
+        if byte < 0x80:
+            return result, pos
+        shift += 7
+
+def read_varint_from(f):
+    result = 0
+    shift = 0
+    while True:
+        byte = ord(read_exactly(f, 1))
+        result |= (byte & 0x7f) << shift
+        if byte < 0x80:
+            return result
+        shift += 7
+
+def unzigzag(value):
+    return (value >> 1) ^ -(value & 1)
+
+def decode_ints(data, encoding, nRows):
+    values = []
+    pos = 0
+    if encoding == RLE_VARINT:
+        while len(values) < nRows:
+            value, pos = read_varint(data, pos)
+            run, pos = read_varint(data, pos)
+            values.extend([unzigzag(value)] * run)
+        return values
+    previous = 0
+    for i in range(nRows):
+        value, pos = read_varint(data, pos)
+        value = unzigzag(value)
+        if encoding == DELTA_VARINT:
+            value += previous
+            previous = value
+        values.append(value)
+    return values
+
+def read_columnar(infile):
+    """Returns (names, types, columns) of a columnar trace, columns is a list of lists"""
+    header = read_exactly(infile, 8)
+    if header[:4] != COLUMNAR_MAGIC:
+        raise ValueError('not a columnar trace')
+    version = struct.unpack('<I', header[4:])[0]
+    if version != COLUMNAR_VERSION:
+        raise ValueError('unsupported columnar trace version %d' % version)
+
+    names = []
+    types = []
+    for i in range(read_varint_from(infile)):
+        types.append(ord(read_exactly(infile, 1)))
+        names.append(read_exactly(infile, read_varint_from(infile)).decode('utf-8'))
+
+    columns = [[] for name in names]
+    while True:
+        marker = infile.read(2)
+        if not marker:
+            break
+        if marker != b'RG':
+            raise ValueError('row group expected')
+        nRows = read_varint_from(infile)
+        for i, type in enumerate(types):
+            dictionary = None
+            if type == TYPE_STRING:
+                dictionary = []
+                for j in range(read_varint_from(infile)):
+                    dictionary.append(read_exactly(infile, read_varint_from(infile)).decode('utf-8'))
+            encoding = ord(read_exactly(infile, 1))
+            data = read_exactly(infile, read_varint_from(infile))
+            if encoding == RAW_DOUBLE:
+                columns[i].extend(struct.unpack('<%dd' % nRows, data))
+            elif dictionary is not None:
+                columns[i].extend(dictionary[id] for id in decode_ints(data, encoding, nRows))
+            else:
+                columns[i].extend(decode_ints(data, encoding, nRows))
+    return names, types, columns
+
+def convert_columnar(infile, outfile):
+    names, types, columns = read_columnar(infile)
+    outfile.write('\t'.join(names) + '\n')
+    formats = ['%d' if type == TYPE_INT64 else ('%g' if type == TYPE_DOUBLE else '%s')
+               for type in types]
+    for row in zip(*columns):
+        outfile.write('\t'.join(format % value for format, value in zip(formats, row)) + '\n')
+
+def convert(infile, outfile):
+    header = read_exactly(infile, 8)
+    if header[:4] == COLUMNAR_MAGIC:
+        infile.seek(0)
+        return convert_columnar(infile, outfile)
+    if header[:4] != MAGIC:
+        raise ValueError('not a binary packet trace')
+    version = struct.unpack('<I', header[4:])[0]
+    if version != VERSION:
+        raise ValueError('unsupported trace version %d' % version)
+
+    strings = {}
+    outfile.write('Time\tNode\tFaceId\tFaceDescr\tType\tName\tKilobytes\n')
+    while True:
+        tag = infile.read(1)
+        if not tag:
+            break
+        if tag == b'S':
+            id, length = STRING.unpack(read_exactly(infile, STRING.size))
+            strings[id] = read_exactly(infile, length).decode('utf-8')
+        elif tag == b'P':
+            time, node, faceId, faceDescr, type, name, size = \
+                PACKET.unpack(read_exactly(infile, PACKET.size))
+            # same number format as std::ostream << double
+            outfile.write('%g\t%s\t%d\t%s\t%s\t%s\t%d\n' % (time / 1e9, strings[node], faceId,
+                                                            strings[faceDescr], TYPES[type],
+                                                            strings[name], size))
+        else:
+            raise ValueError('unknown record type %r' % tag)
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Convert a binary or columnar trace to TSV')
+    parser.add_argument('input', type=str, help='Binary or columnar trace file')
+    parser.add_argument('output', type=str, nargs='?', default='-',
+                        help='TSV file (default: stdout)')
+
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as infile:
+        if args.output == '-':
+            convert(infile, sys.stdout)
+        else:
+            with open(args.output, 'w') as outfile:
+                convert(infile, outfile)
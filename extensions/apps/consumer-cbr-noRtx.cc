@@ -173,15 +173,12 @@ ConsumerCbrNoRtx::SendPacket()
 
   uint32_t seq = m_seq++;
 
-  //
-  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_interestName);
-  nameWithSequence->appendSequenceNumber(seq);
-  //
+  Name nameWithSequence(m_interestName);
+  nameWithSequence.appendSequenceNumber(seq);
 
-  // shared_ptr<Interest> interest = make_shared<Interest> ();
-  shared_ptr<Interest> interest = make_shared<Interest>();
+  shared_ptr<Interest> interest = m_packetPool.acquireInterest();
   interest->setNonce(m_rand->GetValue());
-  interest->setName(*nameWithSequence);
+  interest->setName(nameWithSequence);
   time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
   interest->setInterestLifetime(interestLifeTime);
 
@@ -31,6 +31,8 @@
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 #include "ns3/ndnSIM/utils/ndn-rtt-estimator.hpp"
 
+#include "packet-pool.hpp"
+
 #include <set>
 #include <map>
 
@@ -129,6 +131,8 @@ protected:
   Name m_interestName;     ///< \brief NDN Name of the Interest (use Name)
   Time m_interestLifeTime; ///< \brief LifeTime for interest packet
 
+  PacketPool m_packetPool; ///< \brief recycled Interest packets
+
   /// @cond include_hidden
 
   /**
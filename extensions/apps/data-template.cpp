@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "data-template.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/encoding/encoding-buffer.hpp>
+#include <ndn-cxx/meta-info.hpp>
+#include <ndn-cxx/signature-info.hpp>
+
+namespace ns3 {
+namespace ndn {
+
+void
+DataTemplate::prepare(const std::string& messageType, uint32_t qci, time::milliseconds freshness,
+                      const Name& keyLocator, uint32_t signature)
+{
+  m_fixedSize = 0;
+
+  // same element order as Data::wireEncode
+  m_messageType = ::ndn::Block();
+  if (!messageType.empty()) {
+    m_messageType = ::ndn::makeStringBlock(::ndn::tlv::MessageType, messageType);
+    m_fixedSize += m_messageType.size();
+  }
+
+  m_qci = ::ndn::Block();
+  if (qci != 0) {
+    m_qci = ::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::QCI, qci);
+    m_fixedSize += m_qci.size();
+  }
+
+  ::ndn::MetaInfo metaInfo;
+  metaInfo.setFreshnessPeriod(freshness);
+  m_metaInfo = metaInfo.wireEncode();
+  m_fixedSize += m_metaInfo.size();
+
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+  if (keyLocator.size() > 0) {
+    signatureInfo.setKeyLocator(keyLocator);
+  }
+  m_signatureInfo = signatureInfo.wireEncode();
+  m_fixedSize += m_signatureInfo.size();
+
+  m_signatureValue = ::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, signature);
+  m_fixedSize += m_signatureValue.size();
+
+  m_isPrepared = true;
+}
+
+void
+DataTemplate::encode(Data& data, const Name& name, const ::ndn::Block& content) const
+{
+  BOOST_ASSERT(m_isPrepared);
+  BOOST_ASSERT(content.type() == ::ndn::tlv::Content);
+
+  const ::ndn::Block& nameBlock = name.wireEncode();
+
+  size_t valueLength = nameBlock.size() + content.size() + m_fixedSize;
+  ::ndn::EncodingBuffer encoder(valueLength + 2 * 9, 0);
+
+  // (reverse encoding)
+  encoder.prependBlock(m_signatureValue);
+  encoder.prependBlock(m_signatureInfo);
+  encoder.prependBlock(content);
+  encoder.prependBlock(m_metaInfo);
+  if (!m_qci.empty()) {
+    encoder.prependBlock(m_qci);
+  }
+  if (!m_messageType.empty()) {
+    encoder.prependBlock(m_messageType);
+  }
+  encoder.prependBlock(nameBlock);
+
+  encoder.prependVarNumber(valueLength);
+  encoder.prependVarNumber(::ndn::tlv::Data);
+
+  data.wireDecode(encoder.block());
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef DATA_TEMPLATE_H
+#define DATA_TEMPLATE_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Pre-encoded, fake-signed Data packet of a producer
+ *
+ * MessageType, QCI, MetaInfo, SignatureInfo and SignatureValue are identical for every
+ * packet of a producer. They are encoded once by prepare(); encode() then only splices
+ * name and content in between and builds the wire format in a single pass.
+ */
+class DataTemplate
+{
+public:
+  /**
+   * @brief Encodes the blocks shared by all packets
+   *
+   * @param messageType "push", "tainted" or empty for a regular Data packet
+   * @param qci QCI class, 0 if none
+   * @param freshness freshness period of the packets
+   * @param keyLocator name used as key locator, not used if empty
+   * @param signature value of the fake signature
+   */
+  void
+  prepare(const std::string& messageType, uint32_t qci, time::milliseconds freshness,
+          const Name& keyLocator, uint32_t signature);
+
+  bool
+  isPrepared() const
+  {
+    return m_isPrepared;
+  }
+
+  /**
+   * @brief Sets @p data to the wire encoding of a packet with the given name and content
+   *
+   * @param content block of type tlv::Content, e.g. PacketPool::getVirtualPayload()
+   */
+  void
+  encode(Data& data, const Name& name, const ::ndn::Block& content) const;
+
+private:
+  bool m_isPrepared = false;
+
+  ::ndn::Block m_messageType;
+  ::ndn::Block m_qci;
+  ::ndn::Block m_metaInfo;
+  ::ndn::Block m_signatureInfo;
+  ::ndn::Block m_signatureValue;
+
+  /// total size of the pre-encoded blocks
+  size_t m_fixedSize = 0;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // DATA_TEMPLATE_H
@@ -1,43 +1,216 @@
 #include "fixedjitterbuffer.h"
 
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <list>
+
 namespace ns3 {
 namespace ndn {
 
+static std::list<FixedJitterBuffer*> g_buffers;
+
+FixedJitterBuffer::FixedJitterBuffer(const std::string& flow, uint32_t node, Time bufferDelay,
+                                     double frameFrequency, bool isAdaptive)
+  : m_flow(flow)
+  , m_node(node)
+  , m_frameDuration(Seconds(1.0 / frameFrequency))
+  , m_minDelay(bufferDelay)
+  , m_delay(bufferDelay)
+  , m_isAdaptive(isAdaptive)
+  , m_slotSeqs(RING_SIZE, std::numeric_limits<uint64_t>::max())
+  , m_slotArrivals(RING_SIZE, 0)
+  , m_slotSendTimes(RING_SIZE, -1)
+{
+  g_buffers.push_back(this);
+}
+
+FixedJitterBuffer::~FixedJitterBuffer()
+{
+  m_tickEvent.Cancel();
+  g_buffers.remove(this);
+}
+
+void
+FixedJitterBuffer::addFragmentToBuffer(uint64_t seq)
+{
+  addFragment(seq, -1);
+}
+
+void
+FixedJitterBuffer::addFragmentToBuffer(uint64_t seq, Time sendTime)
+{
+  addFragment(seq, sendTime.GetNanoSeconds());
+}
+
+void
+FixedJitterBuffer::addFragment(uint64_t seq, int64_t sendTime)
+{
+  if (m_isStopped) {
+    return;
+  }
+
+  int64_t now = Simulator::Now().GetNanoSeconds();
+  m_stats.nReceived++;
+
+  // transit time up to a constant offset: arrival - nominal generation time
+  int64_t transit = now - static_cast<int64_t>(seq) * m_frameDuration.GetNanoSeconds();
+  if (m_hasTransit) {
+    m_jitter += (std::abs(transit - m_lastTransit) - m_jitter) / 16.0;
+  }
+  m_hasTransit = true;
+  m_lastTransit = transit;
+
+  if (!m_isStarted) {
+    m_isStarted = true;
+    m_nextSeq = seq;
+    m_tickEvent = Simulator::Schedule(m_delay, &FixedJitterBuffer::tryConsumeFragment, this);
+  }
+
+  if (seq < m_nextSeq) {
+    m_stats.nLate++;
+    return;
+  }
+  if (seq >= m_nextSeq + RING_SIZE) {
+    m_stats.nOverflow++;
+    return;
+  }
+
+  size_t slot = seq % RING_SIZE;
+  if (m_slotSeqs[slot] == seq) {
+    m_stats.nDuplicate++;
+    return;
+  }
+  m_slotSeqs[slot] = seq;
+  m_slotArrivals[slot] = now;
+  m_slotSendTimes[slot] = sendTime;
+}
 
-FixedJitterBuffer::FixedJitterBuffer(uint32_t bufferDelay, double fragment_frequency, uint32_t reference_time_point)
+void
+FixedJitterBuffer::tryConsumeFragment()
 {
-  this->fragment_duration = (uint32_t) (1000.0 / fragment_frequency); //ms
-  this->maxBufferDelay = bufferDelay; //ms
-  this->reference_time_point = reference_time_point; //ms
+  int64_t now = Simulator::Now().GetNanoSeconds();
+  size_t slot = m_nextSeq % RING_SIZE;
+
+  if (m_slotSeqs[slot] == m_nextSeq) {
+    m_stats.nPlayed++;
+    m_stats.bufferDelaySum += now - m_slotArrivals[slot];
+    if (m_slotSendTimes[slot] >= 0) {
+      m_stats.mouthToEarSum += now - m_slotSendTimes[slot];
+      m_stats.nMouthToEar++;
+    }
+    m_lossRun = 0;
+  }
+  else {
+    m_stats.nLost++;
+    m_lossRun++;
+    if (m_stats.nPlayed > 0 && m_lossRun <= MAX_CONCEALED_RUN) {
+      m_stats.nConcealed++;
+    }
+  }
+  m_nextSeq++;
+
+  Time next = m_frameDuration;
+  if (m_isAdaptive) {
+    next += adapt();
+  }
+
+  m_tickEvent = Simulator::Schedule(next, &FixedJitterBuffer::tryConsumeFragment, this);
+}
+
+Time
+FixedJitterBuffer::adapt()
+{
+  if (++m_ticksSinceAdapt < ADAPT_INTERVAL) {
+    return Time(0);
+  }
+  m_ticksSinceAdapt = 0;
+
+  Time target = std::max(m_minDelay, NanoSeconds(static_cast<int64_t>(4 * m_jitter)));
+  if (target > m_delay + m_frameDuration) {
+    // play the last frame again, everything after it is played one frame later
+    m_stats.nStretched++;
+    m_delay += m_frameDuration;
+    return m_frameDuration;
+  }
+  if (target + m_frameDuration < m_delay) {
+    // drop the next frame; if it has not arrived, it is lost like at its playout time
+    m_stats.nSkipped++;
+    if (m_slotSeqs[m_nextSeq % RING_SIZE] != m_nextSeq) {
+      m_stats.nLost++;
+    }
+    m_nextSeq++;
+    m_delay -= m_frameDuration;
+  }
+  return Time(0);
 }
 
-void FixedJitterBuffer::addFragmentToBuffer(uint32_t seq)
+void
+FixedJitterBuffer::stop()
 {
-  //check if added before timeout event.
-  uint32_t currentTime = ns3::Simulator::Now ().ToInteger (ns3::Time::MS);
-  uint32_t playbackTime = reference_time_point + (seq * fragment_duration) + maxBufferDelay;
+  m_isStopped = true;
+  m_tickEvent.Cancel();
+}
 
-  fprintf(stderr, "current time = %d\n", currentTime);
-  fprintf(stderr, "packetPlaybackTime = %d\n",playbackTime);
+double
+FixedJitterBuffer::getRFactor() const
+{
+  uint64_t nFrames = m_stats.nPlayed + m_stats.nLost;
+  if (nFrames == 0) {
+    return 0.0;
+  }
 
-  if(currentTime < playbackTime)
-  {
-    //enque
-    buffer[seq] = currentTime;
-    fprintf(stderr,"packet stored\n");
-    //todo store delay
+  double delay = 0.0; // ms
+  if (m_stats.nMouthToEar > 0) {
+    delay = m_stats.mouthToEarSum / 1e6 / m_stats.nMouthToEar;
   }
-  else
-  {
-    //packet to late
-    fprintf(stderr,"packet to late\n");
+  else if (m_stats.nPlayed > 0) {
+    delay = m_stats.bufferDelaySum / 1e6 / m_stats.nPlayed;
   }
 
+  // delay impairment, simplified G.107 (Cole and Rosenbluth)
+  double id = 0.024 * delay + (delay > 177.3 ? 0.11 * (delay - 177.3) : 0.0);
+
+  // effective equipment impairment of G.711 with packet loss concealment (Ie = 0, Bpl = 25.1)
+  double lossPercent = 100.0 * m_stats.nLost / nFrames;
+  double ieEff = 95.0 * lossPercent / (lossPercent + 25.1);
+
+  return std::max(0.0, 93.2 - id - ieEff);
 }
 
-void FixedJitterBuffer::tryConsumeFragment(uint32_t seq)
+double
+FixedJitterBuffer::getMos() const
 {
+  double r = getRFactor();
+  if (r <= 0.0) {
+    return 1.0;
+  }
+  if (r >= 100.0) {
+    return 4.5;
+  }
+  return 1.0 + 0.035 * r + 7e-6 * r * (r - 60.0) * (100.0 - r);
+}
 
+void
+FixedJitterBuffer::printAll(std::ostream& os)
+{
+  os << "Flow\tNode\tReceived\tPlayed\tLate\tLost\tConcealed\tDuplicates\tOverflows"
+     << "\tStretched\tSkipped\tBufferDelay\tMouthToEar\tJitter\tRFactor\tMOS\n";
+
+  for (const FixedJitterBuffer* buffer : g_buffers) {
+    const Stats& stats = buffer->m_stats;
+    os << buffer->m_flow << "\t" << buffer->m_node << "\t"
+       << stats.nReceived << "\t" << stats.nPlayed << "\t" << stats.nLate << "\t"
+       << stats.nLost << "\t" << stats.nConcealed << "\t" << stats.nDuplicate << "\t"
+       << stats.nOverflow << "\t" << stats.nStretched << "\t" << stats.nSkipped << "\t"
+       << (stats.nPlayed == 0 ? 0.0 : stats.bufferDelaySum / 1e6 / stats.nPlayed) << "\t"
+       << (stats.nMouthToEar == 0 ? 0.0 : stats.mouthToEarSum / 1e6 / stats.nMouthToEar) << "\t"
+       << buffer->m_jitter / 1e6 << "\t"
+       << buffer->getRFactor() << "\t" << buffer->getMos() << "\n";
+  }
 }
 
 }
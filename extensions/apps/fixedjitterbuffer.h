@@ -1,32 +1,161 @@
 #ifndef FIXEDJITTERBUFFER_H
 #define FIXEDJITTERBUFFER_H
 
-#include <map>
-#include "ns3-dev/ns3/simulator.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+
+#include <ostream>
+#include <string>
+#include <vector>
 
 namespace ns3 {
 namespace ndn {
 
+/**
+ * @brief Playout buffer of a voice receiver
+ *
+ * The playout clock starts bufferDelay after the first frame arrived. From then on, one
+ * frame is played every 1 / frameFrequency seconds in sequence number order. Arrivals are
+ * stored in a ring indexed by sequence number, so a tick only looks at a single slot.
+ *
+ * A frame that is missing at its playout time counts as lost, a frame arriving afterwards
+ * as late. Up to MAX_CONCEALED_RUN consecutive lost frames are hidden by packet loss
+ * concealment (the last frame is repeated).
+ *
+ * In adaptive mode, the delay follows four times the interarrival jitter (RFC 3550),
+ * but never drops below the configured bufferDelay. Every ADAPT_INTERVAL frames it is
+ * increased by stretching a frame, or decreased by skipping one.
+ *
+ * All buffers are registered so that a scenario can print the statistics of every flow
+ * with printAll(), including the E-model (ITU-T G.107) estimate of the conversational
+ * quality.
+ */
 class FixedJitterBuffer
 {
 public:
-  FixedJitterBuffer(uint32_t bufferDelay, double fragment_frequency, uint32_t reference_time_point);
+  struct Stats
+  {
+    uint64_t nReceived = 0;
+    uint64_t nPlayed = 0;
+    uint64_t nLate = 0;      ///< arrived after the playout time
+    uint64_t nDuplicate = 0;
+    uint64_t nOverflow = 0;  ///< arrived more than RING_SIZE frames early
+    uint64_t nLost = 0;      ///< missing at the playout time, or when skipped
+    uint64_t nConcealed = 0; ///< lost frames hidden by packet loss concealment
+    uint64_t nStretched = 0; ///< frames played twice to increase the delay
+    uint64_t nSkipped = 0;   ///< frames dropped to decrease the delay, received or not
+
+    int64_t bufferDelaySum = 0;     ///< playout - arrival of played frames, nanoseconds
+    int64_t mouthToEarSum = 0;      ///< playout - send of played frames, nanoseconds
+    uint64_t nMouthToEar = 0;       ///< played frames with a known send time
+  };
+
+  static const size_t RING_SIZE = 1024;
+  static const uint32_t MAX_CONCEALED_RUN = 3;
+  static const uint32_t ADAPT_INTERVAL = 50;
+
+  /**
+   * @param flow name of the flow used in the statistics, e.g. the Data prefix
+   * @param node id of the receiving node
+   * @param bufferDelay delay between arrival of the first frame and its playout
+   * @param frameFrequency frames per second
+   * @param isAdaptive adapt the delay to the measured jitter
+   */
+  FixedJitterBuffer(const std::string& flow, uint32_t node, Time bufferDelay,
+                    double frameFrequency, bool isAdaptive = false);
+
+  ~FixedJitterBuffer();
+
+  /**
+   * @brief Stores an arriving frame, starts the playout clock on the first frame
+   */
+  void
+  addFragmentToBuffer(uint64_t seq);
+
+  /**
+   * @brief Stores an arriving frame that was sent at @p sendTime
+   *
+   * The send time is needed for the mouth-to-ear delay.
+   */
+  void
+  addFragmentToBuffer(uint64_t seq, Time sendTime);
+
+  /**
+   * @brief Stops the playout clock, e.g. at the end of a call
+   */
+  void
+  stop();
+
+  const Stats&
+  getStats() const
+  {
+    return m_stats;
+  }
+
+  /**
+   * @brief Rating factor R of the E-model, from 0 (unusable) to 93.2
+   *
+   * Uses the mean mouth-to-ear delay (or the mean buffer delay if no send times are
+   * known) and the loss rate of the played stream, with the G.711 + PLC loss robustness.
+   */
+  double
+  getRFactor() const;
+
+  /**
+   * @brief Mean opinion score derived from getRFactor(), from 1 to 4.5
+   */
+  double
+  getMos() const;
+
+  /**
+   * @brief Writes one summary line per registered buffer, times in milliseconds
+   */
+  static void
+  printAll(std::ostream& os);
+
+private:
+  void
+  addFragment(uint64_t seq, int64_t sendTime);
+
+  /**
+   * @brief Playout tick, plays or conceals the next frame
+   */
+  void
+  tryConsumeFragment();
+
+  /**
+   * @brief Moves the delay towards the jitter target, called on every playout tick
+   *
+   * @return additional time until the next tick, one frame if a frame is stretched
+   */
+  Time
+  adapt();
 
-  void addFragmentToBuffer(uint32_t seq);
-  void tryConsumeFragment(uint32_t seq);
+private:
+  std::string m_flow;
+  uint32_t m_node;
+  Time m_frameDuration;
+  Time m_minDelay;
+  Time m_delay;
+  bool m_isAdaptive;
 
-protected:
-  typedef std::map<
-  uint32_t /*seq_number*/,
-  uint32_t /*received at sim time*/
-  > JitterBuffer;
+  std::vector<uint64_t> m_slotSeqs;
+  std::vector<int64_t> m_slotArrivals;  ///< nanoseconds
+  std::vector<int64_t> m_slotSendTimes; ///< nanoseconds, -1 if unknown
 
-  JitterBuffer buffer;
+  bool m_isStarted = false;
+  bool m_isStopped = false;
+  uint64_t m_nextSeq = 0;
+  uint32_t m_lossRun = 0;
+  uint32_t m_ticksSinceAdapt = 0;
+  EventId m_tickEvent;
 
-  uint32_t maxBufferDelay;
-  uint32_t reference_time_point;
-  uint32_t fragment_duration;
+  // RFC 3550 interarrival jitter, relative to the nominal frame spacing
+  bool m_hasTransit = false;
+  int64_t m_lastTransit = 0;
+  double m_jitter = 0.0; ///< nanoseconds
 
+  Stats m_stats;
 };
 
 }
@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "flow-statistics.hpp"
+
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace ns3 {
+namespace ndn {
+
+size_t
+LogHistogram::getBucket(uint64_t value)
+{
+  if (value < SUB_BUCKETS) {
+    return value;
+  }
+
+  size_t msb = 63 - __builtin_clzll(value);
+  size_t shift = msb - (SUB_BUCKET_BITS - 1);
+  // value >> shift is in [SUB_BUCKETS / 2, SUB_BUCKETS)
+  return SUB_BUCKETS + (shift - 1) * (SUB_BUCKETS / 2) + ((value >> shift) - SUB_BUCKETS / 2);
+}
+
+uint64_t
+LogHistogram::getBucketUpperBound(size_t bucket)
+{
+  if (bucket < SUB_BUCKETS) {
+    return bucket;
+  }
+
+  size_t shift = (bucket - SUB_BUCKETS) / (SUB_BUCKETS / 2) + 1;
+  uint64_t mantissa = (bucket - SUB_BUCKETS) % (SUB_BUCKETS / 2) + SUB_BUCKETS / 2;
+  return ((mantissa + 1) << shift) - 1;
+}
+
+void
+LogHistogram::record(uint64_t value)
+{
+  size_t bucket = getBucket(value);
+  if (bucket >= m_buckets.size()) {
+    m_buckets.resize(bucket + 1, 0);
+  }
+  m_buckets[bucket]++;
+
+  if (m_count == 0 || value < m_min) {
+    m_min = value;
+  }
+  m_max = std::max(m_max, value);
+  m_sum += value;
+  m_count++;
+}
+
+uint64_t
+LogHistogram::getPercentile(double percentile) const
+{
+  if (m_count == 0) {
+    return 0;
+  }
+
+  uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * m_count));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < m_buckets.size(); bucket++) {
+    seen += m_buckets[bucket];
+    if (seen >= rank) {
+      return std::min(getBucketUpperBound(bucket), m_max);
+    }
+  }
+  return m_max;
+}
+
+FlowStatistics&
+FlowStatistics::getInstance()
+{
+  static FlowStatistics instance;
+  return instance;
+}
+
+void
+FlowStatistics::recordSent(const Data& data)
+{
+  if (!m_isEnabled || data.getName().size() == 0 || !data.getName().at(-1).isSequenceNumber()) {
+    return;
+  }
+
+  uint64_t seq = data.getName().at(-1).toSequenceNumber();
+  SentPackets& sent = m_sent[data.getName().getPrefix(-1)];
+  if (sent.seqs.empty()) {
+    // no sequence number maps to a free slot before it is written
+    sent.seqs.resize(SEND_WINDOW, std::numeric_limits<uint64_t>::max());
+    sent.times.resize(SEND_WINDOW, 0);
+  }
+  sent.seqs[seq % SEND_WINDOW] = seq;
+  sent.times[seq % SEND_WINDOW] = Simulator::Now().GetNanoSeconds();
+}
+
+void
+FlowStatistics::recordReceived(const Data& data, uint32_t node)
+{
+  if (!m_isEnabled || data.getName().size() == 0 || !data.getName().at(-1).isSequenceNumber()) {
+    return;
+  }
+
+  Name prefix = data.getName().getPrefix(-1);
+  uint64_t seq = data.getName().at(-1).toSequenceNumber();
+  Flow& flow = m_flows[std::make_pair(prefix, node)];
+  flow.nReceived++;
+
+  auto sent = m_sent.find(prefix);
+  if (sent == m_sent.end() || sent->second.seqs[seq % SEND_WINDOW] != seq) {
+    flow.nUnmatched++;
+    return;
+  }
+
+  int64_t transit = Simulator::Now().GetNanoSeconds() - sent->second.times[seq % SEND_WINDOW];
+  flow.latency.record(transit / 1000);
+
+  if (flow.hasTransit) {
+    int64_t variation = std::abs(transit - flow.lastTransit);
+    flow.delayVariation.record(variation / 1000);
+    flow.jitter += (variation - flow.jitter) / 16.0;
+  }
+  flow.hasTransit = true;
+  flow.lastTransit = transit;
+}
+
+bool
+FlowStatistics::getSendTime(const Data& data, Time& sendTime) const
+{
+  if (!m_isEnabled || data.getName().size() == 0 || !data.getName().at(-1).isSequenceNumber()) {
+    return false;
+  }
+
+  uint64_t seq = data.getName().at(-1).toSequenceNumber();
+  auto sent = m_sent.find(data.getName().getPrefix(-1));
+  if (sent == m_sent.end() || sent->second.seqs[seq % SEND_WINDOW] != seq) {
+    return false;
+  }
+  sendTime = NanoSeconds(sent->second.times[seq % SEND_WINDOW]);
+  return true;
+}
+
+void
+FlowStatistics::print(std::ostream& os) const
+{
+  os << "Prefix\tNode\tReceived\tUnmatched"
+     << "\tLatencyMin\tLatencyMean\tLatency50\tLatency95\tLatency99\tLatencyMax"
+     << "\tIpdvMean\tIpdv95\tIpdv99\tJitter\n";
+
+  for (const auto& entry : m_flows) {
+    const Flow& flow = entry.second;
+    os << entry.first.first << "\t" << entry.first.second << "\t"
+       << flow.nReceived << "\t" << flow.nUnmatched << "\t"
+       << flow.latency.getMin() / 1000.0 << "\t" << flow.latency.getMean() / 1000.0 << "\t"
+       << flow.latency.getPercentile(50) / 1000.0 << "\t"
+       << flow.latency.getPercentile(95) / 1000.0 << "\t"
+       << flow.latency.getPercentile(99) / 1000.0 << "\t"
+       << flow.latency.getMax() / 1000.0 << "\t"
+       << flow.delayVariation.getMean() / 1000.0 << "\t"
+       << flow.delayVariation.getPercentile(95) / 1000.0 << "\t"
+       << flow.delayVariation.getPercentile(99) / 1000.0 << "\t"
+       << flow.jitter / 1e6 << "\n";
+  }
+}
+
+void
+FlowStatistics::clear()
+{
+  m_sent.clear();
+  m_flows.clear();
+}
+
+} // namespace ndn
+} // namespace ns3
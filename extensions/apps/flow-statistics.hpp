@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef FLOW_STATISTICS_H
+#define FLOW_STATISTICS_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/nstime.h"
+
+#include <map>
+#include <ostream>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Histogram with logarithmic buckets for non-negative integer values
+ *
+ * Like an HDR histogram, every power of two is split into SUB_BUCKETS / 2 linear
+ * buckets, so the relative error of a percentile is below 2 / SUB_BUCKETS over the full
+ * value range. Buckets are allocated up to the highest recorded value.
+ */
+class LogHistogram
+{
+public:
+  void
+  record(uint64_t value);
+
+  uint64_t
+  getCount() const
+  {
+    return m_count;
+  }
+
+  uint64_t
+  getMin() const
+  {
+    return m_count == 0 ? 0 : m_min;
+  }
+
+  uint64_t
+  getMax() const
+  {
+    return m_max;
+  }
+
+  double
+  getMean() const
+  {
+    return m_count == 0 ? 0.0 : static_cast<double>(m_sum) / m_count;
+  }
+
+  /**
+   * @brief Returns the upper bound of the bucket holding the @p percentile (0-100)
+   */
+  uint64_t
+  getPercentile(double percentile) const;
+
+private:
+  static size_t
+  getBucket(uint64_t value);
+
+  static uint64_t
+  getBucketUpperBound(size_t bucket);
+
+private:
+  static const size_t SUB_BUCKET_BITS = 6;
+  static const size_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+  std::vector<uint64_t> m_buckets;
+  uint64_t m_count = 0;
+  uint64_t m_sum = 0;
+  uint64_t m_min = 0;
+  uint64_t m_max = 0;
+};
+
+/**
+ * @ingroup ndn-apps
+ * @brief End-to-end latency and jitter of push flows, measured inside the simulation
+ *
+ * Producers record the send time of every push Data by prefix and sequence number,
+ * consumers look it up when the Data arrives. Packets are not modified: the send times
+ * are kept in a per-prefix ring of the last SEND_WINDOW sequence numbers, which is all the
+ * shared simulator memory needs. A flow is a prefix received by one node.
+ *
+ * Per flow, a latency histogram and a histogram of the delay variation between
+ * consecutively received packets (|D| of RFC 3550) are kept, together with the smoothed
+ * RFC 3550 interarrival jitter.
+ *
+ * @note The class uses a singleton pattern. Recording is off until setEnabled(true).
+ *       As the send times are kept per process, producer and consumer must run on the
+ *       same MPI rank; bitvector-length refuses flowStats with more than one rank.
+ */
+class FlowStatistics
+{
+public:
+  static const size_t SEND_WINDOW = 4096;
+
+  static FlowStatistics&
+  getInstance();
+
+  void
+  setEnabled(bool isEnabled)
+  {
+    m_isEnabled = isEnabled;
+  }
+
+  bool
+  isEnabled() const
+  {
+    return m_isEnabled;
+  }
+
+  /**
+   * @brief Records that the producer sends @p data now
+   *
+   * The last name component of @p data is the sequence number.
+   */
+  void
+  recordSent(const Data& data);
+
+  /**
+   * @brief Records that @p node received @p data now
+   */
+  void
+  recordReceived(const Data& data, uint32_t node);
+
+  /**
+   * @brief Looks up when @p data was sent, as recorded by recordSent()
+   *
+   * @return false if recording is off or the send time is no longer known
+   */
+  bool
+  getSendTime(const Data& data, Time& sendTime) const;
+
+  /**
+   * @brief Writes one summary line per flow, times in milliseconds
+   */
+  void
+  print(std::ostream& os) const;
+
+  void
+  clear();
+
+private:
+  FlowStatistics() = default;
+
+  struct SentPackets
+  {
+    std::vector<uint64_t> seqs;
+    std::vector<int64_t> times; ///< nanoseconds
+  };
+
+  struct Flow
+  {
+    uint64_t nReceived = 0;
+    uint64_t nUnmatched = 0; ///< send time was no longer known
+    LogHistogram latency;    ///< microseconds
+    LogHistogram delayVariation; ///< microseconds
+    bool hasTransit = false;
+    int64_t lastTransit = 0; ///< nanoseconds
+    double jitter = 0.0;     ///< RFC 3550 estimate, nanoseconds
+  };
+
+private:
+  bool m_isEnabled = false;
+  std::map<Name, SentPackets> m_sent;
+  std::map<std::pair<Name, uint32_t>, Flow> m_flows;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // FLOW_STATISTICS_H
@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "loss-bitmap.hpp"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+LossBitmap::LossBitmap(uint64_t finalAfter)
+  : m_finalAfter(finalAfter)
+{
+}
+
+void
+LossBitmap::markSent(uint64_t seq)
+{
+  if (!m_hasBase) {
+    m_hasBase = true;
+    m_base = seq;
+  }
+  if (seq < m_base + m_size) {
+    return;
+  }
+
+  // packets that were skipped are never received
+  uint64_t newSize = seq - m_base + 1;
+  m_words.resize((newSize + 63) / 64, 0);
+  for (uint64_t index = m_size; index < newSize; index++) {
+    m_words[index / 64] |= 1ULL << (index % 64);
+  }
+  m_size = newSize;
+
+  if (m_size > m_finalAfter) {
+    scan(m_size - m_finalAfter);
+  }
+}
+
+void
+LossBitmap::markReceived(uint64_t seq)
+{
+  if (!m_hasBase || seq < m_base || seq >= m_base + m_size) {
+    return;
+  }
+
+  uint64_t index = seq - m_base;
+  if (index < m_scanned) {
+    // arrived after it was counted as lost
+    return;
+  }
+  m_words[index / 64] &= ~(1ULL << (index % 64));
+}
+
+bool
+LossBitmap::isLost(uint64_t seq) const
+{
+  return m_hasBase && seq >= m_base && seq < m_base + m_size && getBit(seq - m_base);
+}
+
+void
+LossBitmap::scan(uint64_t end)
+{
+  for (; m_scanned < end; m_scanned++) {
+    bool isLost = getBit(m_scanned);
+
+    if (m_statistics.nPackets > 0) {
+      if (m_isPreviousLost) {
+        m_statistics.nLostFollowed++;
+        m_statistics.nLostToReceived += isLost ? 0 : 1;
+      }
+      else {
+        m_statistics.nReceivedFollowed++;
+        m_statistics.nReceivedToLost += isLost ? 1 : 0;
+      }
+    }
+
+    m_statistics.nPackets++;
+    if (isLost) {
+      m_statistics.nLost++;
+      m_burstLength++;
+    }
+    else if (m_burstLength > 0) {
+      m_statistics.nBursts++;
+      m_statistics.burstLengths[std::min<uint64_t>(m_burstLength, uint64_t(MAX_BURST_LENGTH))]++;
+      m_burstLength = 0;
+    }
+    m_isPreviousLost = isLost;
+  }
+}
+
+const LossBitmap::Statistics&
+LossBitmap::finish()
+{
+  scan(m_size);
+  if (m_burstLength > 0) {
+    m_statistics.nBursts++;
+    m_statistics.burstLengths[std::min<uint64_t>(m_burstLength, uint64_t(MAX_BURST_LENGTH))]++;
+    m_burstLength = 0;
+  }
+  return m_statistics;
+}
+
+void
+LossBitmap::printSummary(std::ostream& os)
+{
+  const Statistics& statistics = finish();
+  os << "packets " << statistics.nPackets << " lost " << statistics.nLost
+     << " loss_rate " << statistics.getLossRate() << " bursts " << statistics.nBursts
+     << " mean_burst " << statistics.getMeanBurstLength()
+     << " p " << statistics.getP() << " q " << statistics.getQ() << " burst_lengths";
+  for (size_t length = 1; length <= MAX_BURST_LENGTH; length++) {
+    if (statistics.burstLengths[length] > 0) {
+      os << " " << length << (length == MAX_BURST_LENGTH ? "+:" : ":") << statistics.burstLengths[length];
+    }
+  }
+}
+
+void
+LossBitmap::writeRunLengths(std::ostream& os) const
+{
+  bool isLostRun = false;
+  uint64_t runLength = 0;
+  for (uint64_t index = 0; index < m_size; index++) {
+    if (getBit(index) != isLostRun) {
+      os << runLength << " ";
+      isLostRun = !isLostRun;
+      runLength = 0;
+    }
+    runLength++;
+  }
+  os << runLength << "\n";
+}
+
+} // namespace ndn
+} // namespace ns3
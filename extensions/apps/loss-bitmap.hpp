@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef LOSS_BITMAP_H
+#define LOSS_BITMAP_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Loss pattern of a stream of consecutively numbered packets
+ *
+ * One bit per sent packet, set while the packet is missing. Burst statistics are
+ * collected on-line: a packet that was sent more than finalAfter packets ago can no
+ * longer be received, so its bit is final and it is added to the statistics.
+ */
+class LossBitmap
+{
+public:
+  static const size_t MAX_BURST_LENGTH = 32;
+
+  struct Statistics
+  {
+    uint64_t nPackets = 0;
+    uint64_t nLost = 0;
+    uint64_t nBursts = 0;
+    /// burstLengths[n] bursts of n lost packets, the last bin counts all longer bursts
+    std::vector<uint64_t> burstLengths = std::vector<uint64_t>(MAX_BURST_LENGTH + 1, 0);
+
+    // transition counts of the two-state Markov chain
+    uint64_t nReceivedFollowed = 0;
+    uint64_t nReceivedToLost = 0;
+    uint64_t nLostFollowed = 0;
+    uint64_t nLostToReceived = 0;
+
+    double
+    getLossRate() const
+    {
+      return nPackets == 0 ? 0.0 : static_cast<double>(nLost) / nPackets;
+    }
+
+    double
+    getMeanBurstLength() const
+    {
+      return nBursts == 0 ? 0.0 : static_cast<double>(nLost) / nBursts;
+    }
+
+    /**
+     * @brief Gilbert-Elliott p, probability to go from the good to the bad state
+     *
+     * The parameters are estimated for the simple Gilbert model (all packets are lost in
+     * the bad state and received in the good state), as in RFC 3611.
+     */
+    double
+    getP() const
+    {
+      return nReceivedFollowed == 0 ? 0.0 : static_cast<double>(nReceivedToLost) / nReceivedFollowed;
+    }
+
+    /**
+     * @brief Gilbert-Elliott q, probability to go from the bad to the good state
+     */
+    double
+    getQ() const
+    {
+      return nLostFollowed == 0 ? 1.0 : static_cast<double>(nLostToReceived) / nLostFollowed;
+    }
+  };
+
+  /**
+   * @param finalAfter number of packets sent after a packet until it counts as lost
+   */
+  explicit
+  LossBitmap(uint64_t finalAfter = 1024);
+
+  /**
+   * @brief Marks @p seq as missing, sequence numbers must be sent in increasing order
+   */
+  void
+  markSent(uint64_t seq);
+
+  /**
+   * @brief Marks @p seq as received, unknown sequence numbers are ignored
+   */
+  void
+  markReceived(uint64_t seq);
+
+  bool
+  isLost(uint64_t seq) const;
+
+  /**
+   * @brief Finalizes all packets sent so far and returns the statistics
+   */
+  const Statistics&
+  finish();
+
+  /**
+   * @brief Writes a one-line summary of finish()
+   */
+  void
+  printSummary(std::ostream& os);
+
+  /**
+   * @brief Writes the loss pattern as alternating run lengths, starting with received packets
+   */
+  void
+  writeRunLengths(std::ostream& os) const;
+
+private:
+  bool
+  getBit(uint64_t index) const
+  {
+    return (m_words[index / 64] >> (index % 64)) & 1;
+  }
+
+  /**
+   * @brief Adds the packets with index below @p end to the statistics
+   */
+  void
+  scan(uint64_t end);
+
+private:
+  uint64_t m_finalAfter;
+  bool m_hasBase = false;
+  uint64_t m_base = 0;
+  uint64_t m_size = 0; ///< number of sent packets
+  std::vector<uint64_t> m_words;
+
+  uint64_t m_scanned = 0;
+  bool m_isPreviousLost = false;
+  uint64_t m_burstLength = 0;
+  Statistics m_statistics;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // LOSS_BITMAP_H
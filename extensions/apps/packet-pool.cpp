@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "packet-pool.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+#include <map>
+
+namespace ns3 {
+namespace ndn {
+
+PacketPool::PacketPool(size_t capacity)
+  : m_capacity(capacity)
+{
+  m_data.reserve(m_capacity);
+  m_interests.reserve(m_capacity);
+}
+
+template<typename T>
+shared_ptr<T>
+PacketPool::acquire(std::vector<shared_ptr<T>>& slots, size_t& cursor)
+{
+  for (size_t i = 0; i < slots.size(); i++) {
+    shared_ptr<T>& slot = slots[cursor];
+    cursor = (cursor + 1) % slots.size();
+
+    // only the pool holds this packet, nobody can observe that it is reset
+    if (slot.use_count() == 1) {
+      *slot = T();
+      m_reuses++;
+      return slot;
+    }
+  }
+
+  auto packet = make_shared<T>();
+  m_allocations++;
+  if (slots.size() < m_capacity) {
+    slots.push_back(packet);
+  }
+  return packet;
+}
+
+shared_ptr<Data>
+PacketPool::acquireData()
+{
+  return acquire(m_data, m_nextData);
+}
+
+shared_ptr<Interest>
+PacketPool::acquireInterest()
+{
+  return acquire(m_interests, m_nextInterest);
+}
+
+const ::ndn::Block&
+PacketPool::getVirtualPayload(size_t size)
+{
+  static std::map<size_t, ::ndn::Block> payloads;
+
+  auto it = payloads.find(size);
+  if (it == payloads.end()) {
+    std::vector<uint8_t> zeros(size, 0);
+    it = payloads.insert({size, ::ndn::makeBinaryBlock(::ndn::tlv::Content, zeros.data(), zeros.size())}).first;
+  }
+  return it->second;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PACKET_POOL_H
+#define PACKET_POOL_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Recycles the Data and Interest objects an application sends
+ *
+ * NFD keeps references to packets handed over by an application (PIT in-records, content
+ * store) via shared_from_this(). A pooled object is therefore only handed out again once
+ * the pool holds the last reference to it; packets that are still in use are never touched.
+ * If all slots are busy, a fresh object is allocated and, while the pool is not full, kept
+ * for later reuse.
+ */
+class PacketPool
+{
+public:
+  /**
+   * @param capacity maximum number of Data and of Interest objects kept for reuse
+   */
+  explicit
+  PacketPool(size_t capacity = 32);
+
+  /**
+   * @brief Returns an empty Data packet (as if it was created with make_shared<Data>())
+   */
+  shared_ptr<Data>
+  acquireData();
+
+  /**
+   * @brief Returns an empty Interest packet (as if it was created with make_shared<Interest>())
+   */
+  shared_ptr<Interest>
+  acquireInterest();
+
+  /**
+   * @brief Returns an encoded Content block with @p size zero bytes
+   *
+   * The block is created once per payload size and shared by all applications, so that
+   * Data::setContent() neither allocates nor copies the virtual payload.
+   */
+  static const ::ndn::Block&
+  getVirtualPayload(size_t size);
+
+  /**
+   * @brief Number of packet objects allocated on the heap by this pool
+   */
+  uint64_t
+  getAllocations() const
+  {
+    return m_allocations;
+  }
+
+  /**
+   * @brief Number of packet objects handed out again without allocation
+   */
+  uint64_t
+  getReuses() const
+  {
+    return m_reuses;
+  }
+
+private:
+  template<typename T>
+  shared_ptr<T>
+  acquire(std::vector<shared_ptr<T>>& slots, size_t& cursor);
+
+private:
+  size_t m_capacity;
+
+  std::vector<shared_ptr<Data>> m_data;
+  std::vector<shared_ptr<Interest>> m_interests;
+  size_t m_nextData = 0;
+  size_t m_nextInterest = 0;
+
+  uint64_t m_allocations = 0;
+  uint64_t m_reuses = 0;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // PACKET_POOL_H
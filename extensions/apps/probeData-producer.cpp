@@ -79,6 +79,10 @@ ProbeDataProducer::StartApplication()
   NS_LOG_FUNCTION_NOARGS();
   App::StartApplication();
 
+  time::milliseconds freshness(m_freshness.GetMilliSeconds());
+  m_dataTemplate.prepare("", 0, freshness, m_keyLocator, m_signature);
+  m_taintedDataTemplate.prepare("tainted", 0, freshness, m_keyLocator, m_signature);
+
   FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
 }
 
@@ -104,35 +108,14 @@ ProbeDataProducer::OnInterest(shared_ptr<const Interest> interest)
   // dataName.append(m_postfix);
   // dataName.appendVersion();
 
-  auto data = make_shared<Data>();
-  data->setName(dataName);
-  data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
-
-  data->setContent(make_shared< ::ndn::Buffer>(m_virtualPayloadSize));
-
   // This adds support for probing alongside Persistent Interests.
-  if (interest->isTainted())
-  {
-    data->setTainted(true);
-  }
-
-  Signature signature;
-  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+  const DataTemplate& dataTemplate = interest->isTainted() ? m_taintedDataTemplate : m_dataTemplate;
 
-  if (m_keyLocator.size() > 0) {
-    signatureInfo.setKeyLocator(m_keyLocator);
-  }
-
-  signature.setInfo(signatureInfo);
-  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
-
-  data->setSignature(signature);
+  auto data = m_packetPool.acquireData();
+  dataTemplate.encode(*data, dataName, PacketPool::getVirtualPayload(m_virtualPayloadSize));
 
   NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
 
-  // to create real wire encoding
-  data->wireEncode();
-
   m_transmittedDatas(data, this, m_face);
   m_appLink->onReceiveData(*data);
 }
@@ -28,6 +28,9 @@
 #include "ns3/nstime.h"
 #include "ns3/ptr.h"
 
+#include "data-template.hpp"
+#include "packet-pool.hpp"
+
 namespace ns3 {
 namespace ndn {
 
@@ -63,6 +66,10 @@ protected:
 
   uint32_t m_signature;
   Name m_keyLocator;
+
+  PacketPool m_packetPool;
+  DataTemplate m_dataTemplate;
+  DataTemplate m_taintedDataTemplate;
 };
 
 } // namespace ndn
@@ -18,6 +18,7 @@
  **/
 
 #include "push-consumer.hpp"
+#include "flow-statistics.hpp"
 #include "ns3/ptr.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -75,6 +76,15 @@ PushConsumer::GetTypeId(void)
                     "QoS class Identifier (QCI)",
                     UintegerValue(0), MakeUintegerAccessor(&PushConsumer::m_qci), MakeUintegerChecker<uint32_t>())
 
+      .AddAttribute("JitterBuffer", "Playout delay of the jitter buffer, 0 disables it", StringValue("0ms"),
+                    MakeTimeAccessor(&PushConsumer::m_jitterBufferDelay), MakeTimeChecker())
+
+      .AddAttribute("AdaptiveJitterBuffer", "Adapt the playout delay to the measured jitter", BooleanValue(false),
+                    MakeBooleanAccessor(&PushConsumer::m_isJitterBufferAdaptive), MakeBooleanChecker())
+
+      .AddAttribute("FrameFrequency", "Frames per second played out by the jitter buffer", StringValue("100"),
+                    MakeDoubleAccessor(&PushConsumer::m_frameFrequency), MakeDoubleChecker<double>())
+
     ;
 
   return tid;
@@ -83,6 +93,8 @@ PushConsumer::GetTypeId(void)
 PushConsumer::PushConsumer()
   : m_frequency(1.0)
   , m_firstTime(true)
+  , m_isJitterBufferAdaptive(false)
+  , m_frameFrequency(100.0)
 {
   NS_LOG_FUNCTION_NOARGS();
   m_seqMax = std::numeric_limits<uint32_t>::max();
@@ -99,6 +111,25 @@ PushConsumer::OnData(shared_ptr<const Data> data)
     return;
 
   Consumer::OnData(data); // tracing inside
+  FlowStatistics::getInstance().recordReceived(*data, GetNode()->GetId());
+
+  if (!m_jitterBufferDelay.IsZero() && data->getName().size() > 0 && data->getName().at(-1).isSequenceNumber()) {
+    Name prefix = data->getName().getPrefix(-1);
+    shared_ptr<FixedJitterBuffer>& buffer = m_jitterBuffers[prefix];
+    if (buffer == nullptr) {
+      buffer = make_shared<FixedJitterBuffer>(prefix.toUri(), GetNode()->GetId(), m_jitterBufferDelay,
+                                              m_frameFrequency, m_isJitterBufferAdaptive);
+    }
+
+    uint64_t seq = data->getName().at(-1).toSequenceNumber();
+    Time sendTime;
+    if (FlowStatistics::getInstance().getSendTime(*data, sendTime)) {
+      buffer->addFragmentToBuffer(seq, sendTime);
+    }
+    else {
+      buffer->addFragmentToBuffer(seq);
+    }
+  }
 
 /*
   NS_LOG_FUNCTION(this << data);
@@ -130,6 +161,15 @@ PushConsumer::OnData(shared_ptr<const Data> data)
   m_rtt->AckSeq(SequenceNumber32(seq)); */
 }
 
+void
+PushConsumer::StopApplication()
+{
+  for (auto& buffer : m_jitterBuffers) {
+    buffer.second->stop();
+  }
+  Consumer::StopApplication();
+}
+
 void
 PushConsumer::ScheduleNextPacket()
 {
@@ -198,16 +238,10 @@ PushConsumer::SendPacket()
   //   seq = m_seq++;
   // }
 
-  //
-  shared_ptr<Name> name = make_shared<Name>(m_interestName);
-  //nameWithSequence->appendSequenceNumber(seq);
-  //
-
-  // shared_ptr<Interest> interest = make_shared<Interest> ();
-  shared_ptr<Interest> interest = make_shared<Interest>();
+  shared_ptr<Interest> interest = m_packetPool.acquireInterest();
   time::milliseconds creationTime(Now().GetMilliSeconds());
   interest->setNonce(creationTime.count() + (rand() % 1000));
-  interest->setName(*name);
+  interest->setName(m_interestName);
   if (m_firstTime) {
     interest->setPush(true);
     if (m_probeFrequency > 0) {
@@ -256,13 +290,13 @@ PushConsumer::SendProbe()
   //std::string oldNameString =  m_interestName.toUri(); 
   std::string probeNameString = oldNameString + PROBE_SUFFIX; 
   uint32_t seq = rand() % 1000000; // should be UUID, but that's out of scope for now. 
-  shared_ptr<Name> probeNameWithSequence = make_shared<Name>(probeNameString); 
-  probeNameWithSequence->appendSequenceNumber(seq); 
+  Name probeNameWithSequence(probeNameString); 
+  probeNameWithSequence.appendSequenceNumber(seq); 
 
-  shared_ptr<Interest> probeInterest = make_shared<Interest>();     
+  shared_ptr<Interest> probeInterest = m_packetPool.acquireInterest();     
   time::milliseconds creationTime(ns3::Now().GetMilliSeconds()); 
   probeInterest->setNonce(creationTime.count() + (rand() % 1000)); 
-  probeInterest->setName(*probeNameWithSequence);  
+  probeInterest->setName(probeNameWithSequence);  
   probeInterest->setPush(false); 
   probeInterest->setTainted(false); 
   probeInterest->setQCI(m_qci); 
@@ -24,6 +24,11 @@
 
 #include "ns3/ndnSIM/apps/ndn-consumer.hpp"
 
+#include "fixedjitterbuffer.h"
+#include "packet-pool.hpp"
+
+#include <map>
+
 namespace ns3 {
 namespace ndn {
 
@@ -48,6 +53,9 @@ public:
   OnData(shared_ptr<const Data> contentObject);
 
 protected:
+  virtual void
+  StopApplication();
+
   /**
    * \brief Constructs the Interest packet and sends it using a callback to the underlying NDN
    * protocol
@@ -93,6 +101,13 @@ protected:
   Time m_refreshInterval; 
   std::string m_use_refresh_pi = "false";
   uint32_t m_qci = 0;
+
+  PacketPool m_packetPool;
+
+  Time m_jitterBufferDelay; // 0 disables the playout buffer
+  bool m_isJitterBufferAdaptive;
+  double m_frameFrequency;
+  std::map<Name, shared_ptr<FixedJitterBuffer>> m_jitterBuffers; // per pushed prefix
 };
 
 } // namespace ndn
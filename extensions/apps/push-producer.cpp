@@ -18,6 +18,7 @@
  **/
 
 #include "push-producer.hpp"
+#include "flow-statistics.hpp"
 #include "ns3/log.h"
 #include "ns3/string.h"
 #include "ns3/uinteger.h"
@@ -87,6 +88,9 @@ PushProducer::StartApplication()
   NS_LOG_FUNCTION_NOARGS();
   App::StartApplication();
 
+  m_dataTemplate.prepare("push", m_qci, ::ndn::time::milliseconds(m_freshness.GetMilliSeconds()),
+                         m_keyLocator, m_signature);
+
   FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
 }
 
@@ -95,6 +99,9 @@ PushProducer::StopApplication()
 {
   NS_LOG_FUNCTION_NOARGS();
 
+  NS_LOG_INFO("Packet pool: " << m_packetPool.getAllocations() << " allocations, "
+              << m_packetPool.getReuses() << " reuses");
+
   App::StopApplication();
 }
 
@@ -130,34 +137,13 @@ PushProducer::SendPacket() {
   // Only increase sequence number if it is a regular packet
   m_seq++; 
 
-  auto data = make_shared<Data>();
-  data->setName(dataName);
-  data->setPush(true);  
-  
-  data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
-
-  data->setContent(make_shared< ::ndn::Buffer>(m_virtualPayloadSize));
-  if (m_qci != 0) {
-    data->setQCI(m_qci);
-  }
-
-  Signature signature;
-  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
-
-  if (m_keyLocator.size() > 0) {
-    signatureInfo.setKeyLocator(m_keyLocator);
-  }
-
-  signature.setInfo(signatureInfo);
-  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
-
-  data->setSignature(signature);
+  // push flag, QCI, freshness and signature come from the template
+  auto data = m_packetPool.acquireData();
+  m_dataTemplate.encode(*data, dataName, PacketPool::getVirtualPayload(m_virtualPayloadSize));
+  FlowStatistics::getInstance().recordSent(*data);
 
   NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
 
-  // to create real wire encoding
-  data->wireEncode();
-
   m_transmittedDatas(data, this, m_face);
   m_appLink->onReceiveData(*data);
 
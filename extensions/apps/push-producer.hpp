@@ -24,6 +24,9 @@
 #include "ns3/ndnSIM/apps/ndn-app.hpp"
 #include "ns3/ndnSIM/model/ndn-common.hpp"
 
+#include "data-template.hpp"
+#include "packet-pool.hpp"
+
 #include "ns3/nstime.h"
 #include "ns3/ptr.h"
 
@@ -81,6 +84,9 @@ private:
 
   uint32_t m_signature;
   Name m_keyLocator;
+
+  PacketPool m_packetPool;
+  DataTemplate m_dataTemplate;
 };
 
 } // namespace ndn
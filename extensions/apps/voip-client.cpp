@@ -18,6 +18,7 @@
  **/
 
 #include "voip-client.hpp"
+#include "flow-statistics.hpp"
 #include "ns3/ptr.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
@@ -70,7 +71,12 @@ VoipClient::GetTypeId(void)
                     "Type of send time randomization: none (default), uniform, exponential",
                     StringValue("none"),
                     MakeStringAccessor(&VoipClient::SetRandomize),
-                    MakeStringChecker());
+                    MakeStringChecker())
+
+      .AddAttribute("JitterBuffer", "Playout delay of the jitter buffer, 0 disables it", StringValue("0ms"),
+                    MakeTimeAccessor(&VoipClient::m_jitterBufferDelay), MakeTimeChecker())
+      .AddAttribute("AdaptiveJitterBuffer", "Adapt the playout delay to the measured jitter", BooleanValue(false),
+                    MakeBooleanAccessor(&VoipClient::m_isJitterBufferAdaptive), MakeBooleanChecker());
 
     ;
 
@@ -90,6 +96,9 @@ VoipClient::StartApplication()
   NS_LOG_FUNCTION_NOARGS();
   App::StartApplication();
 
+  // todo: Freshness Period is now unlimited
+  m_dataTemplate.prepare("push", m_qci, ::ndn::time::milliseconds(0), m_keyLocator, m_signature);
+
   FibHelper::AddRoute(GetNode(), m_name, m_face, 0);
 
   VoipClient::SendPacket();
@@ -100,6 +109,14 @@ VoipClient::StopApplication()
 {
   NS_LOG_FUNCTION_NOARGS();
   m_active = false;
+  for (auto& partner : m_communicationPartners) {
+    partner.second.refreshEvent.Cancel();
+  }
+  for (auto& buffer : m_jitterBuffers) {
+    buffer.second->stop();
+  }
+  NS_LOG_INFO("Packet pool: " << m_packetPool.getAllocations() << " allocations, "
+              << m_packetPool.getReuses() << " reuses");
   // cleanup base stuff
   App::StopApplication();
 }
@@ -126,12 +143,16 @@ VoipClient::AddCommunicationPartner(std::string communicationPartner)
   if (communicationPartner.size() == 0) {
     return;
   }
-  if (m_lifeTimes.find(communicationPartner) != m_lifeTimes.end()) {
-    return;
+  // configured partners never expire, their refresh timers start with the application
+  if (m_communicationPartners.insert({communicationPartner, {time::milliseconds(0), EventId()}}).second) {
+    NS_LOG_DEBUG("communicationPartner added, total " << m_communicationPartners.size());
   }
-  m_communicationPartner.push_back(communicationPartner);
-  m_lifeTimes.insert({{communicationPartner, time::milliseconds(0)}});
-  NS_LOG_DEBUG("communicationPartner added, total " << m_communicationPartner.size());
+}
+
+size_t
+VoipClient::GetNumCommunicationPartners() const
+{
+  return m_communicationPartners.size();
 }
 
 void
@@ -142,6 +163,26 @@ VoipClient::OnData(shared_ptr<const Data> data)
     return;
 
   Consumer::OnData(data); // tracing inside
+  FlowStatistics::getInstance().recordReceived(*data, GetNode()->GetId());
+
+  if (!m_jitterBufferDelay.IsZero() && data->getName().size() > 0 && data->getName().at(-1).isSequenceNumber()) {
+    // partners send at the same rate as this client
+    Name prefix = data->getName().getPrefix(-1);
+    shared_ptr<FixedJitterBuffer>& buffer = m_jitterBuffers[prefix];
+    if (buffer == nullptr) {
+      buffer = make_shared<FixedJitterBuffer>(prefix.toUri(), GetNode()->GetId(), m_jitterBufferDelay,
+                                              m_dataFrequency, m_isJitterBufferAdaptive);
+    }
+
+    uint64_t seq = data->getName().at(-1).toSequenceNumber();
+    Time sendTime;
+    if (FlowStatistics::getInstance().getSendTime(*data, sendTime)) {
+      buffer->addFragmentToBuffer(seq, sendTime);
+    }
+    else {
+      buffer->addFragmentToBuffer(seq);
+    }
+  }
 
 /*
   NS_LOG_FUNCTION(this << data);
@@ -190,17 +231,15 @@ VoipClient::OnInterest(shared_ptr<const Interest> interest)
     nameStr = interest->getRequesterName();
   }
 
-  m_communicationPartner.push_back(nameStr);
-  auto lifetimePair = m_lifeTimes.find(nameStr);
-  if (lifetimePair != m_lifeTimes.end()) {
-    if (lifetimePair->second > time::milliseconds(0)) {
+  auto partner = m_communicationPartners.find(nameStr);
+  if (partner != m_communicationPartners.end()) {
+    if (partner->second.expiry > time::milliseconds(0)) {
       NS_LOG_DEBUG("Updated timeout for: " << nameStr);
-      lifetimePair->second = timeout;
+      partner->second.expiry = timeout;
     }
   } else {
     NS_LOG_DEBUG("New callee registered: " << nameStr);
-    m_lifeTimes.insert({{nameStr, timeout}});  
-    m_communicationPartner.push_back(nameStr);
+    m_communicationPartners.insert({nameStr, {timeout, EventId()}});
     m_firstTime = true;
     VoipClient::SendInterest(nameStr);
   }
@@ -221,12 +260,15 @@ VoipClient::ScheduleNextPacket(std::string callee)
   //  m_firstTime = false;
   //}
   //else 
-  // if (!m_sendEvent.IsRunning()) {
-    NS_LOG_DEBUG("Schedule interest for " << callee);
-    m_sendEvent = Simulator::Schedule((m_random == 0) ? m_refreshInterval
-                                                      : Seconds(m_random->GetValue()),
-                                                      &VoipClient::SendInterest, this, callee);
-  // }
+  auto partner = m_communicationPartners.find(callee);
+  if (partner == m_communicationPartners.end()) {
+    return;
+  }
+  NS_LOG_DEBUG("Schedule interest for " << callee);
+  partner->second.refreshEvent.Cancel();
+  partner->second.refreshEvent = Simulator::Schedule((m_random == 0) ? m_refreshInterval
+                                                                    : Seconds(m_random->GetValue()),
+                                                     &VoipClient::SendInterest, this, callee);
 }
 
 void
@@ -243,34 +285,27 @@ VoipClient::SendInterest(std::string callee)
 
   NS_LOG_FUNCTION(callee);
 
-  auto it = std::find (m_communicationPartner.begin(), m_communicationPartner.end(), callee);
-  if (it == m_communicationPartner.end()) {
+  auto partner = m_communicationPartners.find(callee);
+  if (partner == m_communicationPartners.end()) {
     NS_LOG_DEBUG("Cancel send event because no communication partner was found: " << callee);
     return;
   }
 
-  auto lifeTimePair = m_lifeTimes.find(callee);
-  if (lifeTimePair != m_lifeTimes.end()) {
-    if (lifeTimePair->second > time::milliseconds(0) && lifeTimePair->second < time::milliseconds(Simulator::Now().GetMilliSeconds())) {
-      NS_LOG_DEBUG("Lifetime of callee " << callee << " exceeded");
-      m_communicationPartner.erase(std::remove(m_communicationPartner.begin(), m_communicationPartner.end(), callee), m_communicationPartner.end());
-      //std::remove(m_communicationPartner.begin(), m_communicationPartner.end(), callee);
-      m_lifeTimes.erase(callee);
-      return;
-    }
+  const time::milliseconds& expiry = partner->second.expiry;
+  if (expiry > time::milliseconds(0) && expiry < time::milliseconds(Simulator::Now().GetMilliSeconds())) {
+    NS_LOG_DEBUG("Lifetime of callee " << callee << " exceeded");
+    partner->second.refreshEvent.Cancel();
+    m_communicationPartners.erase(partner);
+    return;
   }
 
-  //
-  shared_ptr<Name> name = make_shared<Name>(callee);
-
-  // shared_ptr<Interest> interest = make_shared<Interest> ();
-  shared_ptr<Interest> interest = make_shared<Interest>();
+  shared_ptr<Interest> interest = m_packetPool.acquireInterest();
   time::milliseconds creationTime(Now().GetMilliSeconds());
   if (m_qci != 0) {
     interest->setQCI(m_qci);
   }
   interest->setNonce(creationTime.count() + (rand() % 1000));
-  interest->setName(*name);
+  interest->setName(Name(callee));
   interest->setPush(true);
   if (m_firstTime) {
     m_firstTime = false;
@@ -298,12 +333,15 @@ VoipClient::SendPacket()
 
   NS_LOG_FUNCTION_NOARGS();
 
-  for (auto iterator = m_communicationPartner.begin(); iterator != m_communicationPartner.end(); iterator++) {
-
-    std::string callee = *iterator;
+  // SendInterest may evict the partner, so iterate over a copy of the names
+  std::vector<std::string> callees;
+  callees.reserve(m_communicationPartners.size());
+  for (const auto& partner : m_communicationPartners) {
+    callees.push_back(partner.first);
+  }
+  for (const std::string& callee : callees) {
     //NS_LOG_DEBUG("Call SendInterest for " << callee);
     VoipClient::SendInterest(callee);
-
   }
 }
 
@@ -319,35 +357,13 @@ VoipClient::SendData() {
   // dataName.append(m_postfix);
   // dataName.appendVersion();
 
-  auto data = make_shared<Data>();
-  data->setName(dataName);
-  data->setPush(true); 
-  
-  // todo: Freshness Period is now unlimited
-  data->setFreshnessPeriod(::ndn::time::milliseconds(0));
-
-  data->setContent(make_shared< ::ndn::Buffer>(m_virtualPayloadSize));
-  if (m_qci != 0) {
-    data->setQCI(m_qci);
-  }
-
-  Signature signature;
-  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
-
-  if (m_keyLocator.size() > 0) {
-    signatureInfo.setKeyLocator(m_keyLocator);
-  }
-
-  //signature.setInfo(signatureInfo);
-  //signature.setValue(::ndn::nonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
-
-  //data->setSignature(signature);
+  // push flag, QCI, freshness and signature come from the template
+  auto data = m_packetPool.acquireData();
+  m_dataTemplate.encode(*data, dataName, PacketPool::getVirtualPayload(m_virtualPayloadSize));
+  FlowStatistics::getInstance().recordSent(*data);
 
   //NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
 
-  // to create real wire encoding
-  data->wireEncode();
-
   m_transmittedDatas(data, this, m_face);
   m_appLink->onReceiveData(*data);
   //m_face->sendData(*data);
@@ -24,6 +24,13 @@
 
 #include "ns3/ndnSIM/apps/ndn-consumer.hpp"
 
+#include "data-template.hpp"
+#include "fixedjitterbuffer.h"
+#include "packet-pool.hpp"
+
+#include <map>
+#include <unordered_map>
+
 namespace ns3 {
 namespace ndn {
 
@@ -60,6 +67,12 @@ public:
   std::string
   GetName(void);
 
+  /**
+   * @brief Number of partners that currently get refresh Interests
+   */
+  size_t
+  GetNumCommunicationPartners() const;
+
   /**
    * @brief Set type of frequency randomization
    * @param value Either 'none', 'uniform', or 'exponential'
@@ -103,15 +116,27 @@ protected:
   Ptr<RandomVariableStream> m_random;
   uint32_t m_qci = 0;
   std::string m_name = "";
-  std::vector<std::string> m_communicationPartner;
-  std::unordered_map<std::string, time::milliseconds> m_lifeTimes;
 
-  bool m_producing;
+  struct CommunicationPartner
+  {
+    time::milliseconds expiry; ///< end of the partner's last Interest lifetime, 0 never expires
+    EventId refreshEvent;      ///< next refresh Interest, at most one per partner
+  };
+  std::unordered_map<std::string, CommunicationPartner> m_communicationPartners;
+
+  bool m_producing = false;
   double m_dataFrequency;
   uint32_t m_seq = 0;
   uint32_t m_virtualPayloadSize;
-  uint32_t m_signature;
+  uint32_t m_signature = 0;
   Name m_keyLocator;
+
+  PacketPool m_packetPool;
+  DataTemplate m_dataTemplate;
+
+  Time m_jitterBufferDelay; // 0 disables the playout buffer
+  bool m_isJitterBufferAdaptive = false;
+  std::map<Name, shared_ptr<FixedJitterBuffer>> m_jitterBuffers; // per communication partner
 };
 
 } // namespace ndn
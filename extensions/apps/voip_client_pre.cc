@@ -13,6 +13,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
 NS_LOG_COMPONENT_DEFINE("ndn.VoipClientPre");
 
@@ -31,20 +32,21 @@ VoipClientPre::GetTypeId(void)
       .AddConstructor<VoipClientPre>()
       .AddAttribute("LookaheadLiftime", "The Time (ms) an Interest is send before the Data will be generated at the Producer", IntegerValue(1000),
                     MakeIntegerAccessor(&VoipClientPre::lookahead_lifetime), MakeIntegerChecker<int32_t>())
-      .AddAttribute("BurstLogFile", "The Time (ms) an Interest is send before the Data will be generated at the Producer", StringValue(""),
+      .AddAttribute("BurstLogFile", "File for the loss summary and the run-length encoded loss pattern of the call", StringValue(""),
                     MakeStringAccessor(&VoipClientPre::burstLogFile), MakeStringChecker())
-      /*.AddAttribute("JitterBufferSize", "jitter buffer size in ms", IntegerValue(50),
-                    MakeIntegerAccessor(&VoipClientPre::jitterBufferSize), MakeIntegerChecker<int32_t>())*/
+      .AddAttribute("JitterBuffer", "Playout delay of the jitter buffer, 0 disables it", StringValue("0ms"),
+                    MakeTimeAccessor(&VoipClientPre::jitterBufferDelay), MakeTimeChecker())
+      .AddAttribute("AdaptiveJitterBuffer", "Adapt the playout delay to the measured jitter", BooleanValue(false),
+                    MakeBooleanAccessor(&VoipClientPre::adaptiveJitterBuffer), MakeBooleanChecker())
 
       ;
   return tid;
 }
 
 VoipClientPre::VoipClientPre()
+  : adaptiveJitterBuffer(false)
 {
   NS_LOG_FUNCTION_NOARGS();
-  // first_packet = true;
-  // fragmentToConsume = 0;
 }
 
 VoipClientPre::~VoipClientPre()
@@ -53,24 +55,25 @@ VoipClientPre::~VoipClientPre()
 
 void VoipClientPre::StopApplication ()
 {
+  std::ostringstream summary;
+  lossBitmap.printSummary (summary);
+  NS_LOG_INFO ("Loss of " << m_interestName << ": " << summary.str ());
+
   if(!burstLogFile.empty ())
   {
     std::ofstream f (burstLogFile);
     if(f.is_open())
     {
-      f << "seq_nr, lost\n";
-      for(uint32_t i = 0 ; i < m_seq; i++)
-      {
-        f << boost::lexical_cast<std::string>(i)
-        << ","
-        <<  boost::lexical_cast<std::string>(lmap[i])
-        << "\n";
-      }
+      f << "# " << summary.str () << "\n";
+      f << "# run lengths, alternating received and lost, starting with received\n";
+      lossBitmap.writeRunLengths (f);
       f.close ();
     }
     else
       fprintf(stderr, "could not open file: %s\n", burstLogFile.c_str ());
   }
+  if (jbuffer != nullptr)
+    jbuffer->stop ();
   ConsumerCbrNoRtx::StopApplication ();
 }
 
@@ -80,13 +83,6 @@ void VoipClientPre::SendPacket()
   if (!m_active)
     return;
 
-  /*if(first_packet)
-  {
-    jbuffer = shared_ptr<FixedJitterBuffer>(
-          new FixedJitterBuffer(jitterBufferSize,m_frequency,ns3::Simulator::Now ().ToInteger (ns3::Time::MS) + lookahead_lifetime));
-    first_packet = false;
-  }*/
-
   if (m_seqMax != std::numeric_limits<uint32_t>::max())
   {
     if (m_seq >= m_seqMax) {
@@ -96,22 +92,21 @@ void VoipClientPre::SendPacket()
 
   uint32_t seq = m_seq++;
 
-  //
-  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_interestName);
+  Name nameWithSequence(m_interestName);
 
   //lets append the sim time when the data packet shall be availabe at the producer
   //Time::From(ns3::Simulator::Now().To(ns3::Time::MS) + lookahead_lifetime, ns3::Time::MS)
   //nameWithSequence->appendTimestamp();
-  nameWithSequence->appendNumber(ns3::Simulator::Now ().ToInteger (ns3::Time::MS) + lookahead_lifetime);
+  nameWithSequence.appendNumber(ns3::Simulator::Now ().ToInteger (ns3::Time::MS) + lookahead_lifetime);
 
-  lmap[seq] = true;
+  lossBitmap.markSent (seq);
 
-  nameWithSequence->appendSequenceNumber(seq);
+  nameWithSequence.appendSequenceNumber(seq);
 
   // shared_ptr<Interest> interest = make_shared<Interest> ();
-  shared_ptr<Interest> interest = make_shared<Interest>();
+  shared_ptr<Interest> interest = m_packetPool.acquireInterest();
   interest->setNonce(m_rand->GetValue());
-  interest->setName(*nameWithSequence);
+  interest->setName(nameWithSequence);
   time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds()+lookahead_lifetime);
   interest->setInterestLifetime(interestLifeTime);
 
@@ -131,8 +126,17 @@ void VoipClientPre::OnData(shared_ptr<const Data> data)
   ConsumerCbrNoRtx::OnData(data); // tracing inside
   uint32_t seq = data->getName().at(-1).toSequenceNumber();
 
-  lmap[seq] = false;
-  //jbuffer->addFragmentToBuffer(seq);
+  lossBitmap.markReceived (seq);
+
+  if (!jitterBufferDelay.IsZero ())
+  {
+    if (jbuffer == nullptr)
+      jbuffer = make_shared<FixedJitterBuffer>(m_interestName.toUri (), GetNode ()->GetId (), jitterBufferDelay,
+                                               m_frequency, adaptiveJitterBuffer);
+
+    // the producer generates the Data at the time encoded in the name
+    jbuffer->addFragmentToBuffer (seq, MilliSeconds (data->getName ().at (-2).toNumber ()));
+  }
 }
 
 } // namespace ndn
@@ -4,6 +4,7 @@
 
 #include "consumer-cbr-noRtx.h"
 #include "fixedjitterbuffer.h"
+#include "loss-bitmap.hpp"
 
 namespace ns3 {
 namespace ndn {
@@ -26,20 +27,14 @@ public:
 
 protected:
 
-  typedef std::map<
-  uint32_t /*seq_number*/,
-  bool /*true if packet lost*/
-  > LossMap;
-
-  LossMap lmap;
+  LossBitmap lossBitmap;
   std::string burstLogFile;
 
-  //shared_ptr<FixedJitterBuffer> jbuffer;
+  shared_ptr<FixedJitterBuffer> jbuffer;
 
-  //uint32_t fragmentToConsume;
   int lookahead_lifetime;
-  //int jitterBufferSize;
-  //bool first_packet;
+  Time jitterBufferDelay; // 0 disables the playout buffer
+  bool adaptiveJitterBuffer;
 };
 
 } // namespace ndn
@@ -94,6 +94,15 @@ VoIPProducer::~VoIPProducer()
   }
 }
 
+void
+VoIPProducer::StartApplication()
+{
+  Producer::StartApplication();
+
+  m_dataTemplate.prepare("", m_qci, ::ndn::time::milliseconds(m_freshness.GetMilliSeconds()),
+                         m_keyLocator, m_signature);
+}
+
 void
 VoIPProducer::OnInterest(shared_ptr<const Interest> interest)
 {
@@ -125,33 +134,12 @@ VoIPProducer::OnInterest(shared_ptr<const Interest> interest)
     // dataName.append(m_postfix);
     // dataName.appendVersion();
 
-    auto data = make_shared<Data>();
-    data->setName(dataName);
-    data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
-
-    data->setContent(make_shared< ::ndn::Buffer>(m_virtualPayloadSize));
-    if (m_qci != 0) {
-      data->setQCI(m_qci);
-    }
-
-    Signature signature;
-    SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
-
-    if (m_keyLocator.size() > 0) {
-      signatureInfo.setKeyLocator(m_keyLocator);
-    }
-
-    signature.setInfo(signatureInfo);
-    signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
-
-    data->setSignature(signature);
-
+    // QCI, freshness and signature come from the template
+    auto data = m_packetPool.acquireData();
+    m_dataTemplate.encode(*data, dataName, PacketPool::getVirtualPayload(m_virtualPayloadSize));
 
     NS_LOG_INFO("node(" << GetNode()->GetId() << ") responding with Data: " << data->getName());
 
-    // to create real wire encoding
-    data->wireEncode();
-
     m_transmittedDatas(data, this, m_face);
     m_appLink->onReceiveData(*data);
   }
@@ -24,6 +24,9 @@
 
 #include "ns3/ndnSIM/apps/ndn-producer.hpp"
 
+#include "data-template.hpp"
+#include "packet-pool.hpp"
+
 namespace ns3 {
 namespace ndn {
 
@@ -51,9 +54,15 @@ public:
   ns3::EventId removePendingEvent;
 
 protected:
+  virtual void
+  StartApplication();
+
   void removeExpiredEvents();
 
   uint32_t m_qci = 0;
+
+  PacketPool m_packetPool;
+  DataTemplate m_dataTemplate;
 };
 
 } // namespace ndn
@@ -1,22 +1,41 @@
 #include "networkgenerator.h"
+#include "../tracers/columnar-writer.hpp"
 #include "ns3/double.h"
 
+#include "ns3/object-factory.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#include "ns3/mpi-receiver.h"
+#include "ns3/point-to-point-remote-channel.h"
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <unordered_map>
+
 using namespace ns3;
 using namespace ns3::ndn;
 
 NS_LOG_COMPONENT_DEFINE ("NetworkGenerator");
 
-NetworkGenerator::NetworkGenerator(std::string conf_file, std::string queueName, uint32_t queueSize)
+NetworkGenerator::NetworkGenerator(std::string conf_file, std::string queueName, uint32_t queueSize, uint32_t systemCount)
 {
   rvariable = CreateObject<UniformRandomVariable>();
   m_queueName = queueName;
   m_queueSize = queueSize;
   this->briteHelper = new NDNBriteHelper(conf_file, queueName, queueSize);
-  briteHelper->BuildBriteTopology ();
+  if(systemCount > 1)
+    briteHelper->BuildBriteTopology (systemCount);
+  else
+    briteHelper->BuildBriteTopology ();
+  buildIndex ();
 
-  for(int i=0; i<getAllASNodes ().size (); i++)
+  for(int i=0; i<m_allASNodes.size (); i++)
   {
-    Names::Add (std::string("Node_" + boost::lexical_cast<std::string>(i)), getAllASNodes ().Get (i));
+    Names::Add (std::string("Node_" + boost::lexical_cast<std::string>(i)), m_allASNodes.Get (i));
   }
 }
 
@@ -25,15 +44,27 @@ NetworkGenerator::NetworkGenerator(std::string conf_file, std::string seed_file,
   rvariable = CreateObject<UniformRandomVariable>();
   this->briteHelper = new NDNBriteHelper(conf_file, seed_file, newseed_file);
   briteHelper->BuildBriteTopology ();
+  buildIndex ();
 
-  for(int i=0; i<getAllASNodes ().size (); i++)
+  for(int i=0; i<m_allASNodes.size (); i++)
   {
-    Names::Add (std::string("Node_" + boost::lexical_cast<std::string>(i)), getAllASNodes ().Get (i));
+    Names::Add (std::string("Node_" + boost::lexical_cast<std::string>(i)), m_allASNodes.Get (i));
   }
   m_queueName = "";
   m_queueSize = 0;
 }
 
+NetworkGenerator::NetworkGenerator()
+  : briteHelper(NULL)
+{
+  rvariable = CreateObject<UniformRandomVariable>();
+  // the BRITE helper allocates a second stream for its seeds. Allocating it here as well keeps
+  // the automatically assigned streams of all later random variables the same as in a generated run
+  CreateObject<UniformRandomVariable>();
+  m_queueName = "";
+  m_queueSize = 0;
+}
+
 void NetworkGenerator::randomlyPlaceNodes(int nodeCount, std::string setIdentifier, NodePlacement place, PointToPointHelper *p2p)
 {
   std::vector<int> allAS;
@@ -67,14 +98,17 @@ void NetworkGenerator::randomlyPlaceNodes (int nodeCount, std::string setIdentif
   }
 
   NodeContainer customNodes;
-  customNodes.Create (nodeCount);
 
-  for(int i=0; i<customNodes.size (); i++)
+  for(int i=0; i<nodeCount; i++)
   {
-    Names::Add (std::string(setIdentifier + "_" + boost::lexical_cast<std::string>(i)), customNodes.Get (i));
-
     int rand = rvariable->GetInteger (0,container.size ()-1);
-    p2p->Install (customNodes.Get (i), container.Get (rand));
+
+    // same MPI rank as the router, placed nodes never add links between ranks
+    Ptr<Node> node = CreateObject<Node> (container.Get (rand)->GetSystemId ());
+    customNodes.Add (node);
+    Names::Add (std::string(setIdentifier + "_" + boost::lexical_cast<std::string>(i)), node);
+
+    installLink (*p2p, node, container.Get (rand));
   }
   nodeContainerMap[setIdentifier] = customNodes;
 }
@@ -101,7 +135,7 @@ void NetworkGenerator::randomlyAddConnectionsBetweenAllAS(int numberOfConnection
 
         NodeContainer container = getPairOfUnconnectedNodes(i, j);
         if(container.size () == 2)
-          p2p.Install (container.Get (0), container.Get (1));
+          installLink (p2p, container.Get (0), container.Get (1));
         else
           NS_LOG_UNCOND("Unable to add new Connections");
       }
@@ -140,7 +174,7 @@ void NetworkGenerator::randomlyAddConnectionsBetweenTwoAS(int numberOfConnection
 
     NodeContainer container = getPairOfUnconnectedNodes(number_as1, number_as2);
     if(container.size () == 2)
-      p2p.Install (container.Get (0), container.Get (1));
+      installLink (p2p, container.Get (0), container.Get (1));
     else
       NS_LOG_UNCOND("Unable to add new Connections");
   }
@@ -166,7 +200,7 @@ void NetworkGenerator::randomlyAddConnectionsBetweenTwoNodesPerAS(int numberOfCo
 
       NodeContainer container = getPairOfUnconnectedNodes(as, as);
       if(container.size () == 2)
-        p2p.Install (container.Get (0), container.Get (1));
+        installLink (p2p, container.Get (0), container.Get (1));
       else
         NS_LOG_UNCOND("Unable to add new Connections");
     }
@@ -175,42 +209,29 @@ void NetworkGenerator::randomlyAddConnectionsBetweenTwoNodesPerAS(int numberOfCo
 
 int NetworkGenerator::getNumberOfAS ()
 {
-  return briteHelper->GetNAs ();
+  return m_asNodes.size ();
 }
 
 int NetworkGenerator::getNumberOfNodesInAS (int ASnumber)
 {
-  if(getNumberOfAS () < ASnumber)
+  if(ASnumber >= 0 && ASnumber < getNumberOfAS ())
   {
-    return briteHelper->GetNNodesForAs (ASnumber);
+    return m_asNodes[ASnumber].size ();
   }
   return 0;
 }
 
 NodeContainer NetworkGenerator::getAllASNodes()
 {
-  NodeContainer container;
-
-  for(int as=0; as < getNumberOfAS (); as++)
-  {
-    container.Add (getAllASNodesFromAS(as));
-  }
-  return container;
+  return m_allASNodes;
 }
 
 NodeContainer NetworkGenerator::getAllASNodesFromAS(int ASnumber)
 {
-  NodeContainer container;
-
-  if(getNumberOfAS () < ASnumber)
-    return container;
+  if(ASnumber < 0 || ASnumber >= getNumberOfAS ())
+    return NodeContainer();
 
-  for(int node=0; node < briteHelper->GetNNodesForAs(ASnumber); node++)
-  {
-    container.Add (briteHelper->GetNodeForAs (ASnumber,node));
-  }
-
-  return container;
+  return m_asNodes[ASnumber];
 }
 
 NodeContainer NetworkGenerator::getAllLeafNodes()
@@ -227,16 +248,10 @@ NodeContainer NetworkGenerator::getAllLeafNodes()
 
 NodeContainer NetworkGenerator::getAllLeafNodesFromAS(int ASnumber)
 {
-  NodeContainer container;
-
-  if(getNumberOfAS () < ASnumber)
-    return container;
+  if(ASnumber < 0 || ASnumber >= getNumberOfAS ())
+    return NodeContainer();
 
-  for(int node=0; node < briteHelper->GetNLeafNodesForAs (ASnumber); node++)
-  {
-    container.Add (briteHelper->GetLeafNodeForAs(ASnumber,node));
-  }
-  return container;
+  return m_asLeafNodes[ASnumber];
 }
 
 NodeContainer NetworkGenerator::getCustomNodes(std::string setIdentifier)
@@ -254,7 +269,7 @@ void NetworkGenerator::creatRandomLinkFailure(double minTimestamp, double maxTim
 {
   int rand = rvariable->GetInteger(0,getNumberOfAS() - 1);
 
-  NodeContainer c = getAllASNodesFromAS(rand);
+  const NodeContainer& c = m_asNodes[rand];
   rand = rvariable->GetInteger (0, c.size ()-1);
 
   Ptr<Node> node = c.Get (rand);
@@ -280,19 +295,52 @@ void NetworkGenerator::creatRandomLinkFailure(double minTimestamp, double maxTim
     double errorRate = rvariable->GetValue(minErrorRate, maxErrorRate);
 
     //std::cout << "Fail Link between " << channelNodes.Get(0)->GetId() << " and " << channelNodes.Get (1)->GetId() << " from " << startTime << " to " << stopTime << std::endl;
-    std::stringstream loggingInfo;
-    loggingInfo << channelNodes.Get(0)->GetId() << "\t" << channelNodes.Get(1)->GetId() << "\t" << startTime << "\t" << stopTime << "\t" << errorRate;
-    m_linkFailures.push_back(loggingInfo.str());
-
-    // todo: add error rate
-    Simulator::Schedule (MilliSeconds (startTime), ns3::ndn::LinkControlHelper::FailLink, channelNodes.Get (0), channelNodes.Get (1), errorRate);
-    Simulator::Schedule (MilliSeconds (stopTime), ns3::ndn::LinkControlHelper::UpLink,   channelNodes.Get (0), channelNodes.Get (1));
+    scheduleLinkFailure (channelNodes.Get (0), channelNodes.Get (1), startTime, stopTime, errorRate);
 
     //fprintf(stderr, "Start LinkFail between %s and %s: %f\n",Names::FindName (channelNodes.Get (0)).c_str (),Names::FindName (channelNodes.Get (1)).c_str (), startTime);
     //fprintf(stderr, "Stop LinkFail between %s and %s: %f\n\n",Names::FindName (channelNodes.Get (0)).c_str (),Names::FindName (channelNodes.Get (1)).c_str (),stopTime);
   }
 }
 
+void NetworkGenerator::scheduleLinkFailure (Ptr<Node> n1, Ptr<Node> n2, double startTime, double stopTime, double errorRate)
+{
+  std::stringstream loggingInfo;
+  loggingInfo << n1->GetId() << "\t" << n2->GetId() << "\t" << startTime << "\t" << stopTime << "\t" << errorRate;
+  m_linkFailures.push_back(loggingInfo.str());
+  m_linkFailureSchedule.push_back({n1->GetId (), n2->GetId (), startTime, stopTime, errorRate});
+
+  m_failureEngine.schedule (n1, n2, MilliSeconds (startTime), MilliSeconds (stopTime), errorRate);
+}
+
+void NetworkGenerator::loadLinkFailureSchedule (std::string fname)
+{
+  std::set<uint32_t> coreNodes;
+  for(NodeContainer::Iterator n = m_allASNodes.Begin (); n != m_allASNodes.End (); ++n)
+    coreNodes.insert ((*n)->GetId ());
+
+  // sorted, m_links iterates in hash order
+  std::vector<uint64_t> keys (m_links.begin (), m_links.end ());
+  std::sort (keys.begin (), keys.end ());
+
+  std::map<std::string, std::vector<LinkFailureEngine::NodePair> > linkSets;
+  for(uint64_t key : keys)
+  {
+    LinkFailureEngine::NodePair link (key >> 32, key & 0xffffffff);
+    linkSets["all"].push_back (link);
+    if(coreNodes.count (link.first) > 0 && coreNodes.count (link.second) > 0)
+      linkSets["core"].push_back (link);
+  }
+
+  for(const LinkFailureEngine::Failure& failure : LinkFailureEngine::ReadSchedule (fname, linkSets, rvariable))
+  {
+    if(failure.node1 >= NodeList::GetNNodes () || failure.node2 >= NodeList::GetNNodes ())
+      NS_FATAL_ERROR ("Unknown node in link failure schedule " << fname);
+
+    scheduleLinkFailure (NodeList::GetNode (failure.node1), NodeList::GetNode (failure.node2),
+                         failure.startTime, failure.stopTime, failure.errorRate);
+  }
+}
+
 void
 NetworkGenerator::setQueue(PointToPointHelper* p2p, std::string queueName, uint32_t queueSize)
 {
@@ -348,24 +396,54 @@ NetworkGenerator::setQueue(PointToPointHelper* p2p, std::string queueName, uint3
   }
 }
 
-bool NetworkGenerator::nodesConnected(Ptr<Node> n1, Ptr<Node> n2)
+void NetworkGenerator::buildIndex ()
 {
-  int n1_nr_dev = n1->GetNDevices ();
+  m_asNodes.resize (briteHelper->GetNAs ());
+  m_asLeafNodes.resize (briteHelper->GetNAs ());
 
-  for(int i = 0; i < n1_nr_dev; i++)
+  for(int as = 0; as < getNumberOfAS (); as++)
   {
-    Ptr<NetDevice> dev = n1->GetDevice (i);
-    Ptr<Channel> channel = dev->GetChannel ();
-    int channel_nr_dev = channel->GetNDevices ();
+    for(int node = 0; node < briteHelper->GetNNodesForAs (as); node++)
+      m_asNodes[as].Add (briteHelper->GetNodeForAs (as, node));
 
-    for(int j = 0; j < channel_nr_dev; j++)
+    for(int node = 0; node < briteHelper->GetNLeafNodesForAs (as); node++)
+      m_asLeafNodes[as].Add (briteHelper->GetLeafNodeForAs (as, node));
+
+    m_allASNodes.Add (m_asNodes[as]);
+  }
+
+  // every BRITE link once per end, the set removes the duplicates
+  for(NodeContainer::Iterator n = m_allASNodes.Begin (); n != m_allASNodes.End (); ++n)
+  {
+    for(uint32_t i = 0; i < (*n)->GetNDevices (); i++)
     {
-      Ptr<Node> con_node = channel->GetDevice (j)->GetNode ();
-      if(n2->GetId () == con_node->GetId ())
-        return true;
+      Ptr<Channel> channel = (*n)->GetDevice (i)->GetChannel ();
+      for(uint32_t j = 0; j < channel->GetNDevices (); j++)
+      {
+        uint32_t peer = channel->GetDevice (j)->GetNode ()->GetId ();
+        if(peer != (*n)->GetId ())
+          m_links.insert (linkKey ((*n)->GetId (), peer));
+      }
     }
   }
-  return false;
+}
+
+void NetworkGenerator::installLink (PointToPointHelper& p2p, Ptr<Node> n1, Ptr<Node> n2)
+{
+  p2p.Install (n1, n2);
+  m_links.insert (linkKey (n1->GetId (), n2->GetId ()));
+}
+
+uint64_t NetworkGenerator::linkKey (uint32_t id1, uint32_t id2)
+{
+  if(id1 > id2)
+    std::swap (id1, id2);
+  return (static_cast<uint64_t>(id1) << 32) | id2;
+}
+
+bool NetworkGenerator::nodesConnected(Ptr<Node> n1, Ptr<Node> n2)
+{
+  return m_links.find (linkKey (n1->GetId (), n2->GetId ())) != m_links.end ();
 }
 
 bool NetworkGenerator::nodesConnected(Ptr<Node> n1, Ptr<Node> n2, int& n1_dev_id, int& n2_dev_id)
@@ -394,46 +472,40 @@ bool NetworkGenerator::nodesConnected(Ptr<Node> n1, Ptr<Node> n2, int& n1_dev_id
 
 NodeContainer NetworkGenerator::getPairOfUnconnectedNodes(int as1, int as2)
 {
-  NodeContainer as1_nodes = getAllASNodesFromAS (as1);
-  NodeContainer as2_nodes = getAllASNodesFromAS (as2);
+  const NodeContainer& as1_nodes = m_asNodes[as1];
+  const NodeContainer& as2_nodes = m_asNodes[as2];
 
-  while(as1_nodes.size () > 0)
+  // pair index p stands for (as1_nodes[p / n2], as2_nodes[p % n2]). Only the positions
+  // touched by the shuffle are stored, all others still hold their own index.
+  uint64_t n2 = as2_nodes.size ();
+  uint64_t nPairs = as1_nodes.size () * n2;
+  std::unordered_map<uint64_t, uint64_t> shuffled;
+
+  for(uint64_t k = 0; k < nPairs; k++)
   {
-    int rand_node_1 = rvariable->GetInteger (0,as1_nodes.size ()-1);
-    Ptr<Node> as1_node = as1_nodes.Get (rand_node_1);
-    as1_nodes = removeNode (as1_nodes, as1_node);
+    uint64_t remaining = nPairs - k;
+    uint64_t r = k + std::min (remaining - 1, static_cast<uint64_t>(rvariable->GetValue (0, remaining)));
 
-    NodeContainer as2_nodes_cp = as2_nodes;
-    while(as2_nodes_cp.size () > 0)
-    {
-      int rand_node_2 = rvariable->GetInteger (0,as2_nodes_cp.size ()-1);
-      Ptr<Node> as2_node = as2_nodes_cp.Get (rand_node_2);
-      as2_nodes_cp = removeNode (as2_nodes_cp, as2_node);
+    auto atR = shuffled.find (r);
+    uint64_t pair = atR == shuffled.end () ? r : atR->second;
+    auto atK = shuffled.find (k);
+    shuffled[r] = atK == shuffled.end () ? k : atK->second;
 
-      if(as1_node->GetId () != as2_node->GetId () &&
-         !nodesConnected(as1_node, as2_node))
-      {
-        NodeContainer c;
-        c.Add (as1_node);
-        c.Add (as2_node);
-        return c;
-      }
+    Ptr<Node> as1_node = as1_nodes.Get (pair / n2);
+    Ptr<Node> as2_node = as2_nodes.Get (pair % n2);
+
+    if(as1_node->GetId () != as2_node->GetId () &&
+       !nodesConnected(as1_node, as2_node))
+    {
+      NodeContainer c;
+      c.Add (as1_node);
+      c.Add (as2_node);
+      return c;
     }
   }
   return NodeContainer();
 }
 
-NodeContainer NetworkGenerator::removeNode(NodeContainer container, Ptr<Node> node)
-{
-  NodeContainer result;
-  for(NodeContainer::iterator it = container.begin (); it!=container.end (); ++it)
-  {
-    if( (*it)->GetId() != node->GetId ())
-      result.Add (*it);
-  }
-  return result;
-}
-
 double NetworkGenerator::calculateConnectivity ()
 {
   NodeContainer allNodes;
@@ -506,6 +578,13 @@ NetworkGenerator::exportLinkFailures(std::string fname)
   file.close();
 }
 
+void
+NetworkGenerator::exportLinkFailuresColumnar(std::string fname)
+{
+  ColumnarWriter::writeTable(fname, {"First_Node_ID", "Second_Node_ID", "start", "end", "errorRate"},
+                             m_linkFailures);
+}
+
 void NetworkGenerator::exportCoreNetworkWithFaceInformation(std::string fname)
 {
   ofstream file;
@@ -574,7 +653,7 @@ void NetworkGenerator::introduceError (double min_error_rate, double max_error_r
   if(min_error_rate == 0.0 && max_error_rate == 0.0 || min_error_rate > max_error_rate)
     return;
 
-  NodeContainer c = getAllASNodes ();
+  const NodeContainer& c = m_allASNodes;
 
   for(int i = 0; i < c.size (); i++)
   {
@@ -592,3 +671,278 @@ void NetworkGenerator::introduceError (double min_error_rate, double max_error_r
   }
 
 }
+
+/**
+ * Writes the type and all constructor attributes of @p object, tab separated
+ */
+static void
+writeObjectConfig (std::ostream& os, Ptr<Object> object)
+{
+  TypeId tid = object->GetInstanceTypeId ();
+  os << tid.GetName ();
+
+  while(true)
+  {
+    for(uint32_t i = 0; i < tid.GetAttributeN (); i++)
+    {
+      TypeId::AttributeInformation info = tid.GetAttribute (i);
+      std::string valueType = info.checker->GetValueTypeName ();
+      if(!(info.flags & TypeId::ATTR_CONSTRUCT) || !info.accessor->HasGetter () || !info.accessor->HasSetter () ||
+          valueType == "ns3::PointerValue" || valueType == "ns3::ObjectPtrContainerValue")
+        continue;
+
+      StringValue value;
+      object->GetAttribute (info.name, value);
+      os << "\t" << info.name << "=" << value.Get ();
+    }
+
+    TypeId parent = tid.GetParent ();
+    if(parent == tid)
+      break;
+    tid = parent;
+  }
+}
+
+void NetworkGenerator::exportSnapshot (std::string fname)
+{
+  std::ofstream file (fname.c_str (), ios::out);
+  file << std::setprecision (17);
+
+  std::vector<Ptr<Node> > nodes (m_allASNodes.Begin (), m_allASNodes.End ());
+  for(CustomNodesMap::iterator set = nodeContainerMap.begin (); set != nodeContainerMap.end (); ++set)
+    nodes.insert (nodes.end (), set->second.Begin (), set->second.End ());
+  std::sort (nodes.begin (), nodes.end (),
+             [] (Ptr<Node> n1, Ptr<Node> n2) { return n1->GetId () < n2->GetId (); });
+
+  file << "# NetworkGenerator topology snapshot, see NetworkGenerator::exportSnapshot\n";
+  file << "version\t1\n";
+
+  for(Ptr<Node> node : nodes)
+  {
+    file << "node\t" << node->GetId ();
+    std::string name = Names::FindName (node);
+    if(!name.empty ())
+      file << "\t" << name;
+    file << "\n";
+  }
+
+  for(int as = 0; as < getNumberOfAS (); as++)
+  {
+    file << "as\t" << as;
+    for(NodeContainer::Iterator n = m_asNodes[as].Begin (); n != m_asNodes[as].End (); ++n)
+      file << "\t" << (*n)->GetId ();
+    file << "\n";
+
+    file << "leaves\t" << as;
+    for(NodeContainer::Iterator n = m_asLeafNodes[as].Begin (); n != m_asLeafNodes[as].End (); ++n)
+      file << "\t" << (*n)->GetId ();
+    file << "\n";
+  }
+
+  for(CustomNodesMap::iterator set = nodeContainerMap.begin (); set != nodeContainerMap.end (); ++set)
+  {
+    file << "set\t" << set->first;
+    for(NodeContainer::Iterator n = set->second.Begin (); n != set->second.End (); ++n)
+      file << "\t" << (*n)->GetId ();
+    file << "\n";
+  }
+
+  // channel ids follow the creation order, installing the links in this order again
+  // gives every device the same index on its node
+  std::map<uint32_t, Ptr<Channel> > channels;
+  for(Ptr<Node> node : nodes)
+  {
+    for(uint32_t i = 0; i < node->GetNDevices (); i++)
+    {
+      Ptr<Channel> channel = node->GetDevice (i)->GetChannel ();
+      if(channel != 0)
+        channels[channel->GetId ()] = channel;
+    }
+  }
+
+  for(std::map<uint32_t, Ptr<Channel> >::iterator it = channels.begin (); it != channels.end (); ++it)
+  {
+    Ptr<PointToPointChannel> channel = DynamicCast<PointToPointChannel> (it->second);
+    if(channel == 0 || channel->GetNDevices () != 2)
+      NS_FATAL_ERROR ("Topology snapshots only support point-to-point links");
+
+    Ptr<PointToPointNetDevice> dev1 = DynamicCast<PointToPointNetDevice> (channel->GetDevice (0));
+    Ptr<PointToPointNetDevice> dev2 = DynamicCast<PointToPointNetDevice> (channel->GetDevice (1));
+
+    DataRateValue rate;
+    dev1->GetAttribute ("DataRate", rate);
+    TimeValue delay;
+    channel->GetAttribute ("Delay", delay);
+
+    file << "link\t" << dev1->GetNode ()->GetId () << "\t" << dev2->GetNode ()->GetId ()
+         << "\t" << rate.Get ().GetBitRate () << "\t" << delay.Get ().GetNanoSeconds () << "\t";
+    writeObjectConfig (file, dev1->GetQueue ());
+    file << "\n";
+  }
+
+  for(const LinkFailure& failure : m_linkFailureSchedule)
+  {
+    file << "failure\t" << failure.node1 << "\t" << failure.node2 << "\t" << failure.startTime
+         << "\t" << failure.stopTime << "\t" << failure.errorRate << "\n";
+  }
+
+  file.close ();
+}
+
+static Ptr<PointToPointNetDevice>
+createDevice (Ptr<Node> node, DataRate rate, ObjectFactory& queueFactory)
+{
+  // same steps as PointToPointHelper::Install
+  Ptr<PointToPointNetDevice> device = CreateObject<PointToPointNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  device->SetDataRate (rate);
+  node->AddDevice (device);
+  device->SetQueue (queueFactory.Create<Queue> ());
+  return device;
+}
+
+static Ptr<PointToPointChannel>
+createChannel (Ptr<PointToPointNetDevice> dev1, Ptr<PointToPointNetDevice> dev2)
+{
+#ifdef NS3_MPI
+  // same as PointToPointHelper::Install, links between ranks are carried by MPI
+  if(MpiInterface::IsEnabled () && dev1->GetNode ()->GetSystemId () != dev2->GetNode ()->GetSystemId ())
+  {
+    for(Ptr<PointToPointNetDevice> device : {dev1, dev2})
+    {
+      Ptr<MpiReceiver> receiver = CreateObject<MpiReceiver> ();
+      receiver->SetReceiveCallback (MakeCallback (&PointToPointNetDevice::Receive, device));
+      device->AggregateObject (receiver);
+    }
+    return CreateObject<PointToPointRemoteChannel> ();
+  }
+#endif
+  return CreateObject<PointToPointChannel> ();
+}
+
+NetworkGenerator* NetworkGenerator::fromSnapshot (std::string fname, uint32_t systemCount)
+{
+  std::ifstream file (fname.c_str ());
+  if(!file)
+    NS_FATAL_ERROR ("Cannot open topology snapshot " << fname);
+
+  std::vector<std::string> rawLines;
+  std::vector<std::vector<std::string> > lines;
+  std::string line;
+  while(std::getline (file, line))
+  {
+    if(line.empty () || line[0] == '#')
+      continue;
+
+    std::vector<std::string> fields;
+    std::istringstream is (line);
+    std::string field;
+    while(std::getline (is, field, '\t'))
+      fields.push_back (field);
+    rawLines.push_back (line);
+    lines.push_back (fields);
+  }
+
+  // nodes are created with their MPI rank, which is known only after reading the AS membership
+  // and the links: an AS runs on rank as % systemCount, a placed node on the rank of its router
+  std::map<std::string, uint32_t> systemIds;
+  if(systemCount > 1)
+  {
+    for(const std::vector<std::string>& fields : lines)
+    {
+      if(fields[0] == "as" && fields.size () >= 2)
+        for(size_t i = 2; i < fields.size (); i++)
+          systemIds[fields[i]] = std::stoul (fields[1]) % systemCount;
+    }
+    for(const std::vector<std::string>& fields : lines)
+    {
+      if(fields[0] != "link" || fields.size () < 3)
+        continue;
+      bool isAS1 = systemIds.count (fields[1]) > 0;
+      bool isAS2 = systemIds.count (fields[2]) > 0;
+      if(isAS1 && !isAS2)
+        systemIds[fields[2]] = systemIds[fields[1]];
+      else if(isAS2 && !isAS1)
+        systemIds[fields[1]] = systemIds[fields[2]];
+    }
+  }
+
+  NetworkGenerator* gen = new NetworkGenerator ();
+  std::map<std::string, Ptr<Node> > nodes; // id in the snapshot -> node
+
+  auto getNode = [&nodes, &fname] (const std::string& id) {
+    std::map<std::string, Ptr<Node> >::iterator node = nodes.find (id);
+    if(node == nodes.end ())
+      NS_FATAL_ERROR ("Unknown node " << id << " in topology snapshot " << fname);
+    return node->second;
+  };
+
+  for(size_t l = 0; l < lines.size (); l++)
+  {
+    const std::vector<std::string>& fields = lines[l];
+    const std::string& type = fields[0];
+    if(type == "version")
+    {
+      if(fields.size () < 2 || fields[1] != "1")
+        NS_FATAL_ERROR ("Unsupported topology snapshot version in " << fname);
+    }
+    else if(type == "node" && fields.size () >= 2)
+    {
+      Ptr<Node> node = CreateObject<Node> (systemIds[fields[1]]);
+      nodes[fields[1]] = node;
+      if(fields.size () > 2)
+        Names::Add (fields[2], node);
+    }
+    else if((type == "as" || type == "leaves") && fields.size () >= 2)
+    {
+      uint32_t as = std::stoul (fields[1]);
+      std::vector<NodeContainer>& containers = type == "as" ? gen->m_asNodes : gen->m_asLeafNodes;
+      if(containers.size () <= as)
+        containers.resize (as + 1);
+      for(size_t i = 2; i < fields.size (); i++)
+        containers[as].Add (getNode (fields[i]));
+      if(type == "as")
+        gen->m_allASNodes.Add (containers[as]);
+    }
+    else if(type == "set" && fields.size () >= 2)
+    {
+      NodeContainer& set = gen->nodeContainerMap[fields[1]];
+      for(size_t i = 2; i < fields.size (); i++)
+        set.Add (getNode (fields[i]));
+    }
+    else if(type == "link" && fields.size () >= 6)
+    {
+      Ptr<Node> n1 = getNode (fields[1]);
+      Ptr<Node> n2 = getNode (fields[2]);
+      DataRate rate (std::stoull (fields[3]));
+
+      ObjectFactory queueFactory;
+      queueFactory.SetTypeId (fields[5]);
+      for(size_t i = 6; i < fields.size (); i++)
+      {
+        size_t pos = fields[i].find ('=');
+        queueFactory.Set (fields[i].substr (0, pos), StringValue (fields[i].substr (pos + 1)));
+      }
+
+      Ptr<PointToPointNetDevice> dev1 = createDevice (n1, rate, queueFactory);
+      Ptr<PointToPointNetDevice> dev2 = createDevice (n2, rate, queueFactory);
+      Ptr<PointToPointChannel> channel = createChannel (dev1, dev2);
+      channel->SetAttribute ("Delay", TimeValue (NanoSeconds (std::stoll (fields[4]))));
+      dev1->Attach (channel);
+      dev2->Attach (channel);
+
+      gen->m_links.insert (linkKey (n1->GetId (), n2->GetId ()));
+    }
+    else if(type == "failure" && fields.size () >= 6)
+    {
+      gen->scheduleLinkFailure (getNode (fields[1]), getNode (fields[2]),
+                                std::stod (fields[3]), std::stod (fields[4]), std::stod (fields[5]));
+    }
+    else
+    {
+      NS_FATAL_ERROR ("Invalid line in topology snapshot " << fname << ": " << rawLines[l]);
+    }
+  }
+
+  return gen;
+}
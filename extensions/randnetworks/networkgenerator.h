@@ -9,12 +9,15 @@
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
 #include "helper/ndn-link-control-helper.hpp"
+#include "../utils/link-failure-engine.hpp"
 
 #include "ns3/names.h"
 #include "ns3/log.h"
 #include "boost/lexical_cast.hpp"
 
 #include <sstream>
+#include <unordered_set>
+#include <vector>
 
 namespace ns3
 {
@@ -34,8 +37,10 @@ public:
   /**
    * @brief NetworkGenerator generates a random network using BRITE.
    * @param conf_file the path to a BRITE configuration file.
+   * @param systemCount number of MPI ranks. The ASs are distributed over the ranks, nodes placed
+   * later run on the rank of the node they are attached to. MPI has to be enabled before.
    */
-  NetworkGenerator(std::string conf_file, std::string queueName, uint32_t queueSize);
+  NetworkGenerator(std::string conf_file, std::string queueName, uint32_t queueSize, uint32_t systemCount = 1);
 
   /**
    * @brief NetworkGenerator generates a random network using BRITE.
@@ -47,6 +52,17 @@ public:
                    std::string seed_file,
                    std::string newseed_file);
 
+  /**
+   * @brief fromSnapshot rebuilds a topology written by exportSnapshot without running BRITE.
+   * Nodes are created in the order of their ids and links in the order they were installed,
+   * so node ids, device indices and names are the same as in the run that wrote the snapshot.
+   * The link failures of the snapshot are scheduled.
+   * @param fname the snapshot file.
+   * @param systemCount number of MPI ranks, distributes the ASs like the BRITE constructor.
+   * @return the generator, owned by the caller.
+   */
+  static NetworkGenerator* fromSnapshot(std::string fname, uint32_t systemCount = 1);
+
 
   /**
    * @brief randomlyPlaceNodes adds nodes randomly to the network topology.
@@ -166,6 +182,14 @@ public:
    */
   void creatRandomLinkFailure(double minTimestamp, double maxTimestamp, double minDuration, double maxDuration, double minErrorRate, double maxErrorRate);
 
+  /**
+   * @brief loadLinkFailureSchedule generates link failures from the failure processes in a
+   * schedule file (see LinkFailureEngine). The link set "all" contains every link of the
+   * generator, "core" the links between BRITE nodes. The failures are exported like random ones.
+   * @param fname the schedule file.
+   */
+  void loadLinkFailureSchedule(std::string fname);
+
   /**
    * @brief introduceError introduces uniform random link errors on all links
    * @param min_error_rate minimum link error rate on a given link
@@ -181,20 +205,63 @@ public:
    */
   void exportLinkFailures(std::string fname);
 
+  /**
+   * @brief Create columnar trace file (see ColumnarWriter) containing all link failures
+   * @param fname Filename
+   */
+  void exportLinkFailuresColumnar(std::string fname);
+
   void exportCoreNetworkWithFaceInformation(std::string fname);
 
+  /**
+   * @brief exportSnapshot writes all nodes with their names, the AS membership, all links with
+   * data rate, delay and queue configuration, the custom node sets and the link failures.
+   * Loading the file with fromSnapshot rebuilds the same topology.
+   * @param fname Filename
+   */
+  void exportSnapshot(std::string fname);
+
 
 protected:
+  NetworkGenerator();
+
   NDNBriteHelper *briteHelper;
 
   void
   setQueue(PointToPointHelper* p2p, std::string queueName, uint32_t queueSize);
 
+  /**
+   * @brief buildIndex caches the nodes of every AS and records all BRITE links in the adjacency index.
+   */
+  void buildIndex();
+
+  /**
+   * @brief installLink connects two nodes and records the link in the adjacency index.
+   */
+  void installLink(PointToPointHelper& p2p, Ptr<Node> n1, Ptr<Node> n2);
+
+  /**
+   * @brief nodesConnected looks the node pair up in the adjacency index, i.e. only
+   * links created by the NetworkGenerator (BRITE, random connections, placed nodes) are known.
+   */
   bool nodesConnected(Ptr<Node> n1, Ptr<Node> n2);
   bool nodesConnected(Ptr<Node> n1, Ptr<Node> n2, int& n1_dev_id, int& n2_dev_id);
   uint64_t getBandwidth(Ptr<Node> n1, Ptr<Node> n2);
+
+  /**
+   * @brief getPairOfUnconnectedNodes draws node pairs of the two ASs without replacement
+   * (partial Fisher-Yates shuffle of the pair indices) until an unconnected pair is found.
+   * @return the two nodes, or an empty container if all pairs are connected.
+   */
   NodeContainer getPairOfUnconnectedNodes(int as1, int as2);
-  NodeContainer removeNode(NodeContainer container, Ptr<Node> node);
+
+  static uint64_t linkKey(uint32_t id1, uint32_t id2);
+
+  /**
+   * @brief scheduleLinkFailure fails the link between n1 and n2 from startTime to stopTime (ms)
+   * and records the failure for exportLinkFailures.
+   */
+  void scheduleLinkFailure(Ptr<Node> n1, Ptr<Node> n2, double startTime, double stopTime, double errorRate);
 
   typedef
   std::map<
@@ -203,6 +270,15 @@ protected:
   > CustomNodesMap;
 
   CustomNodesMap nodeContainerMap;
+
+  // BRITE nodes per AS, built once by buildIndex()
+  std::vector<ns3::NodeContainer> m_asNodes;
+  std::vector<ns3::NodeContainer> m_asLeafNodes;
+  ns3::NodeContainer m_allASNodes;
+
+  // node id pairs of all links, see linkKey()
+  std::unordered_set<uint64_t> m_links;
+
   ns3::Ptr<ns3::UniformRandomVariable> rvariable;
 
   // name of queue implementation
@@ -211,6 +287,20 @@ protected:
 
   // lists for logging purposes
   std::vector<std::string> m_linkFailures;
+
+  struct LinkFailure
+  {
+    uint32_t node1;
+    uint32_t node2;
+    double startTime; // ms
+    double stopTime;  // ms
+    double errorRate;
+  };
+
+  // scheduled link failures, written to the snapshot at full precision
+  std::vector<LinkFailure> m_linkFailureSchedule;
+
+  ns3::ndn::LinkFailureEngine m_failureEngine;
 };
 }
 }
@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "binary-trace-writer.hpp"
+
+#include "ns3/log.h"
+
+#include <boost/functional/hash.hpp>
+
+#include <cstring>
+
+NS_LOG_COMPONENT_DEFINE("ndn.BinaryTraceWriter");
+
+namespace ns3 {
+namespace ndn {
+
+size_t
+BinaryTraceWriter::NameHash::operator()(const Name& name) const
+{
+  const ::ndn::Block& wire = name.wireEncode();
+  return boost::hash_range(wire.wire(), wire.wire() + wire.size());
+}
+
+BinaryTraceWriter::BinaryTraceWriter(const std::string& file, size_t bufferSize)
+  : m_file(std::fopen(file.c_str(), "wb"))
+  , m_bufferSize(bufferSize)
+  , m_nextId(0)
+  , m_isClosing(false)
+{
+  if (m_file == nullptr) {
+    NS_LOG_ERROR("File " << file << " cannot be opened for writing");
+    return;
+  }
+
+  // the records are buffered here, stdio buffering would only copy them again
+  std::setvbuf(m_file, nullptr, _IONBF, 0);
+
+  m_buffer.reserve(m_bufferSize);
+  append("NDNT", 4);
+  appendValue<uint32_t>(VERSION);
+
+  m_thread = std::thread(&BinaryTraceWriter::run, this);
+}
+
+BinaryTraceWriter::~BinaryTraceWriter()
+{
+  if (m_file == nullptr) {
+    return;
+  }
+
+  submitBuffer();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isClosing = true;
+  }
+  m_hasWork.notify_one();
+  m_thread.join();
+
+  std::fclose(m_file);
+}
+
+uint32_t
+BinaryTraceWriter::getStringId(const std::string& str)
+{
+  auto it = m_strings.find(str);
+  if (it != m_strings.end()) {
+    return it->second;
+  }
+
+  uint32_t id = m_nextId++;
+  m_strings.emplace(str, id);
+  writeString(id, str);
+  return id;
+}
+
+uint32_t
+BinaryTraceWriter::getNameId(const Name& name)
+{
+  auto it = m_names.find(name);
+  if (it != m_names.end()) {
+    return it->second;
+  }
+
+  // names mostly contain sequence numbers and are only seen for a few hops,
+  // remembering all of them would keep every name of the simulation in memory
+  if (m_names.size() >= MAX_CACHED_NAMES) {
+    m_names.clear();
+  }
+
+  uint32_t id = m_nextId++;
+  m_names.emplace(name, id);
+  writeString(id, name.toUri());
+  return id;
+}
+
+void
+BinaryTraceWriter::writeString(uint32_t id, const std::string& str)
+{
+  appendValue<uint8_t>('S');
+  appendValue<uint32_t>(id);
+  appendValue<uint32_t>(str.size());
+  append(str.data(), str.size());
+}
+
+void
+BinaryTraceWriter::writePacket(int64_t timeNs, uint32_t node, uint32_t faceId, uint32_t faceDescr,
+                               PacketType type, uint32_t name, uint32_t bytes)
+{
+  appendValue<uint8_t>('P');
+  appendValue<int64_t>(timeNs);
+  appendValue<uint32_t>(node);
+  appendValue<uint32_t>(faceId);
+  appendValue<uint32_t>(faceDescr);
+  appendValue<uint8_t>(type);
+  appendValue<uint32_t>(name);
+  appendValue<uint32_t>(bytes);
+}
+
+void
+BinaryTraceWriter::append(const void* data, size_t size)
+{
+  if (m_buffer.size() + size > m_bufferSize) {
+    submitBuffer();
+  }
+
+  size_t offset = m_buffer.size();
+  m_buffer.resize(offset + size);
+  std::memcpy(m_buffer.data() + offset, data, size);
+}
+
+void
+BinaryTraceWriter::submitBuffer()
+{
+  if (m_buffer.empty()) {
+    return;
+  }
+
+  std::vector<uint8_t> next;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_hasSpace.wait(lock, [this] { return m_pending.size() < MAX_PENDING_BUFFERS; });
+
+    m_pending.push_back(std::move(m_buffer));
+    if (!m_free.empty()) {
+      next = std::move(m_free.back());
+      m_free.pop_back();
+    }
+  }
+  m_hasWork.notify_one();
+
+  next.clear();
+  next.reserve(m_bufferSize);
+  m_buffer = std::move(next);
+}
+
+void
+BinaryTraceWriter::run()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_hasWork.wait(lock, [this] { return !m_pending.empty() || m_isClosing; });
+    if (m_pending.empty()) {
+      return;
+    }
+
+    std::vector<uint8_t> buffer = std::move(m_pending.front());
+    m_pending.pop_front();
+    lock.unlock();
+    m_hasSpace.notify_one();
+
+    if (std::fwrite(buffer.data(), 1, buffer.size(), m_file) != buffer.size()) {
+      NS_LOG_ERROR("Writing trace buffer failed");
+    }
+
+    lock.lock();
+    m_free.push_back(std::move(buffer));
+  }
+}
+
+} // namespace ndn
+} // namespace ns3
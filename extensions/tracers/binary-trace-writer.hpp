@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef BINARY_TRACE_WRITER_H
+#define BINARY_TRACE_WRITER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Writes packet traces as fixed-size binary records
+ *
+ * File layout (little endian):
+ *
+ *     header:     "NDNT" | uint32 version
+ *     string:     uint8 'S' | uint32 id | uint32 length | length bytes
+ *     packet:     uint8 'P' | int64 time (ns) | uint32 node | uint32 faceId |
+ *                 uint32 faceDescr | uint8 type | uint32 name | uint32 bytes
+ *
+ * node, faceDescr and name refer to strings which are written once, before the first
+ * record using them. convert-trace.py turns a file into the TSV format of L3PacketTracer.
+ *
+ * Records are appended to a large buffer. Full buffers are handed to a background thread
+ * which writes them to disk, so the simulation only blocks if the disk falls behind by more
+ * than MAX_PENDING_BUFFERS buffers.
+ */
+class BinaryTraceWriter
+{
+public:
+  enum PacketType : uint8_t {
+    IN_INTEREST = 0,
+    OUT_INTEREST = 1,
+    IN_DATA = 2,
+    OUT_DATA = 3,
+    IN_NACK = 4,
+    OUT_NACK = 5
+  };
+
+  static const uint32_t VERSION = 1;
+
+  /**
+   * @brief Opens @p file for writing, check isOpen() before use
+   * @param bufferSize size of each buffer in bytes
+   */
+  explicit
+  BinaryTraceWriter(const std::string& file, size_t bufferSize = 4 * 1024 * 1024);
+
+  /**
+   * @brief Flushes the remaining records and waits for the background thread
+   */
+  ~BinaryTraceWriter();
+
+  bool
+  isOpen() const
+  {
+    return m_file != nullptr;
+  }
+
+  /**
+   * @brief Returns the id of @p str, writes it to the dictionary on first use
+   */
+  uint32_t
+  getStringId(const std::string& str);
+
+  /**
+   * @brief Returns the id of the URI of @p name
+   *
+   * Names are looked up by their wire encoding, toUri() is only called for new names.
+   * Only the most recent names are remembered, a name that was forgotten is written again
+   * with a new id.
+   */
+  uint32_t
+  getNameId(const Name& name);
+
+  void
+  writePacket(int64_t timeNs, uint32_t node, uint32_t faceId, uint32_t faceDescr,
+              PacketType type, uint32_t name, uint32_t bytes);
+
+private:
+  void
+  writeString(uint32_t id, const std::string& str);
+
+  void
+  append(const void* data, size_t size);
+
+  template<typename T>
+  void
+  appendValue(T value)
+  {
+    append(&value, sizeof(value));
+  }
+
+  void
+  submitBuffer();
+
+  void
+  run();
+
+private:
+  struct NameHash
+  {
+    size_t
+    operator()(const Name& name) const;
+  };
+
+  static const size_t MAX_PENDING_BUFFERS = 4;
+  static const size_t MAX_CACHED_NAMES = 65536;
+
+  FILE* m_file;
+  size_t m_bufferSize;
+  std::vector<uint8_t> m_buffer;
+
+  std::unordered_map<std::string, uint32_t> m_strings;
+  std::unordered_map<Name, uint32_t, NameHash> m_names;
+  uint32_t m_nextId;
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_hasWork;
+  std::condition_variable m_hasSpace;
+  std::deque<std::vector<uint8_t>> m_pending;
+  std::vector<std::vector<uint8_t>> m_free;
+  bool m_isClosing;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // BINARY_TRACE_WRITER_H
@@ -0,0 +1,307 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "columnar-writer.hpp"
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.ColumnarWriter");
+
+namespace ns3 {
+namespace ndn {
+
+ColumnarWriter::ColumnarWriter(const std::string& file, const std::vector<Column>& columns,
+                               size_t rowGroupSize)
+  : m_file(std::fopen(file.c_str(), "wb"))
+  , m_columns(columns)
+  , m_data(columns.size())
+  , m_rowGroupSize(rowGroupSize)
+  , m_nRows(0)
+{
+  if (m_file == nullptr) {
+    NS_LOG_ERROR("File " << file << " cannot be opened for writing");
+    return;
+  }
+
+  m_out.assign({'N', 'D', 'N', 'C'});
+  for (int i = 0; i < 4; i++) {
+    m_out.push_back(static_cast<uint8_t>(VERSION >> (8 * i)));
+  }
+  appendVarint(m_out, m_columns.size());
+  for (const Column& column : m_columns) {
+    m_out.push_back(column.type);
+    appendVarint(m_out, column.name.size());
+    m_out.insert(m_out.end(), column.name.begin(), column.name.end());
+  }
+  write(m_out);
+}
+
+ColumnarWriter::~ColumnarWriter()
+{
+  if (m_file == nullptr) {
+    return;
+  }
+
+  flush();
+  std::fclose(m_file);
+}
+
+void
+ColumnarWriter::set(size_t column, int64_t value)
+{
+  NS_ASSERT(m_columns[column].type == INT64);
+  m_data[column].ints.push_back(value);
+}
+
+void
+ColumnarWriter::set(size_t column, double value)
+{
+  NS_ASSERT(m_columns[column].type == DOUBLE);
+  m_data[column].doubles.push_back(value);
+}
+
+void
+ColumnarWriter::set(size_t column, const std::string& value)
+{
+  NS_ASSERT(m_columns[column].type == STRING);
+  ColumnData& data = m_data[column];
+
+  auto entry = data.dictionary.find(value);
+  if (entry == data.dictionary.end()) {
+    entry = data.dictionary.emplace(value, data.dictionary.size()).first;
+    data.entries.push_back(value);
+  }
+  data.ints.push_back(entry->second);
+}
+
+void
+ColumnarWriter::endRow()
+{
+  m_nRows++;
+  if (m_nRows >= m_rowGroupSize) {
+    flush();
+  }
+}
+
+void
+ColumnarWriter::flush()
+{
+  if (m_file == nullptr || m_nRows == 0) {
+    return;
+  }
+
+  m_out.assign({'R', 'G'});
+  appendVarint(m_out, m_nRows);
+  write(m_out);
+
+  for (size_t i = 0; i < m_columns.size(); i++) {
+    writeColumn(m_columns[i], m_data[i], m_nRows);
+  }
+  m_nRows = 0;
+}
+
+void
+ColumnarWriter::writeColumn(const Column& column, ColumnData& data, size_t nRows)
+{
+  m_out.clear();
+
+  if (column.type == DOUBLE) {
+    NS_ASSERT(data.doubles.size() == nRows);
+    m_out.push_back(RAW_DOUBLE);
+    appendVarint(m_out, nRows * sizeof(double));
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.doubles.data());
+    m_out.insert(m_out.end(), bytes, bytes + nRows * sizeof(double));
+    data.doubles.clear();
+    write(m_out);
+    return;
+  }
+
+  NS_ASSERT(data.ints.size() == nRows);
+  if (column.type == STRING) {
+    appendVarint(m_out, data.entries.size());
+    for (const std::string& entry : data.entries) {
+      appendVarint(m_out, entry.size());
+      m_out.insert(m_out.end(), entry.begin(), entry.end());
+    }
+    data.entries.clear();
+    data.dictionary.clear();
+  }
+
+  encodeInts(data.ints);
+  data.ints.clear();
+  write(m_out);
+}
+
+void
+ColumnarWriter::encodeInts(const std::vector<int64_t>& values)
+{
+  Encoding best = VARINT;
+  size_t bestSize = SIZE_MAX;
+  m_candidate.clear();
+
+  for (Encoding encoding : {VARINT, DELTA_VARINT, RLE_VARINT}) {
+    m_candidate.clear();
+    int64_t previous = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+      switch (encoding) {
+      case VARINT:
+        appendZigzag(m_candidate, values[i]);
+        break;
+      case DELTA_VARINT:
+        appendZigzag(m_candidate, values[i] - previous);
+        previous = values[i];
+        break;
+      default: {
+        size_t run = 1;
+        while (i + run < values.size() && values[i + run] == values[i]) {
+          run++;
+        }
+        appendZigzag(m_candidate, values[i]);
+        appendVarint(m_candidate, run);
+        i += run - 1;
+        break;
+      }
+      }
+    }
+
+    if (m_candidate.size() < bestSize) {
+      best = encoding;
+      bestSize = m_candidate.size();
+    }
+  }
+
+  // encode the winner again instead of keeping three buffers around
+  if (best != RLE_VARINT) {
+    m_candidate.clear();
+    int64_t previous = 0;
+    for (int64_t value : values) {
+      appendZigzag(m_candidate, best == DELTA_VARINT ? value - previous : value);
+      previous = value;
+    }
+  }
+
+  m_out.push_back(best);
+  appendVarint(m_out, m_candidate.size());
+  m_out.insert(m_out.end(), m_candidate.begin(), m_candidate.end());
+}
+
+void
+ColumnarWriter::appendVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+  while (value >= 0x80) {
+    out.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<uint8_t>(value));
+}
+
+void
+ColumnarWriter::write(const std::vector<uint8_t>& bytes)
+{
+  if (std::fwrite(bytes.data(), 1, bytes.size(), m_file) != bytes.size()) {
+    NS_LOG_ERROR("Writing columnar trace failed");
+  }
+}
+
+static bool
+isInteger(const std::string& str)
+{
+  if (str.empty()) {
+    return false;
+  }
+  char* end = nullptr;
+  std::strtoll(str.c_str(), &end, 10);
+  return *end == '\0';
+}
+
+static bool
+isNumber(const std::string& str)
+{
+  if (str.empty()) {
+    return false;
+  }
+  char* end = nullptr;
+  std::strtod(str.c_str(), &end);
+  return *end == '\0';
+}
+
+static std::vector<std::string>
+splitTsv(const std::string& row)
+{
+  std::vector<std::string> fields;
+  std::stringstream stream(row);
+  std::string field;
+  while (std::getline(stream, field, '\t')) {
+    fields.push_back(field);
+  }
+  return fields;
+}
+
+bool
+ColumnarWriter::writeTable(const std::string& file, const std::vector<std::string>& header,
+                           const std::vector<std::string>& rows)
+{
+  std::vector<std::vector<std::string>> table;
+  for (const std::string& row : rows) {
+    table.push_back(splitTsv(row));
+    table.back().resize(header.size());
+  }
+
+  std::vector<Column> columns;
+  for (size_t i = 0; i < header.size(); i++) {
+    bool allIntegers = true;
+    bool allNumbers = true;
+    for (const std::vector<std::string>& fields : table) {
+      allIntegers = allIntegers && isInteger(fields[i]);
+      allNumbers = allNumbers && isNumber(fields[i]);
+    }
+    columns.push_back({header[i], allIntegers ? INT64 : (allNumbers ? DOUBLE : STRING)});
+  }
+
+  ColumnarWriter writer(file, columns);
+  if (!writer.isOpen()) {
+    return false;
+  }
+
+  for (const std::vector<std::string>& fields : table) {
+    for (size_t i = 0; i < columns.size(); i++) {
+      switch (columns[i].type) {
+      case INT64:
+        writer.set(i, static_cast<int64_t>(std::strtoll(fields[i].c_str(), nullptr, 10)));
+        break;
+      case DOUBLE:
+        writer.set(i, std::strtod(fields[i].c_str(), nullptr));
+        break;
+      case STRING:
+        writer.set(i, fields[i]);
+        break;
+      }
+    }
+    writer.endRow();
+  }
+  return true;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef COLUMNAR_WRITER_H
+#define COLUMNAR_WRITER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Writes traces column by column in row groups
+ *
+ * Values are collected per column and written every rowGroupSize rows, so that the R and
+ * Python post-processing can read whole columns without parsing text. convert-trace.py
+ * reads the files and converts them to TSV.
+ *
+ * File layout (little endian, varints are LEB128):
+ *
+ *     header:     "NDNC" | uint32 version | varint nColumns |
+ *                 per column: uint8 type | varint length | name
+ *     row group:  "RG" | varint nRows | per column: uint8 encoding | varint length | data
+ *
+ * Column data by encoding:
+ *
+ *     VARINT:       nRows zigzag varints
+ *     DELTA_VARINT: nRows zigzag varints of the difference to the previous value
+ *     RLE_VARINT:   pairs of zigzag varint value and varint run length
+ *     RAW_DOUBLE:   nRows IEEE doubles
+ *
+ * STRING columns are dictionary encoded per row group, which keeps the memory bounded even
+ * if most names are unique: the column data starts with the dictionary (varint count, then
+ * varint length and bytes per entry), followed by the ids of the rows in one of the integer
+ * encodings. For integer columns the smallest encoding is chosen per row group.
+ */
+class ColumnarWriter
+{
+public:
+  enum Type : uint8_t {
+    INT64 = 0,
+    DOUBLE = 1,
+    STRING = 2
+  };
+
+  enum Encoding : uint8_t {
+    VARINT = 0,
+    DELTA_VARINT = 1,
+    RLE_VARINT = 2,
+    RAW_DOUBLE = 3
+  };
+
+  struct Column
+  {
+    std::string name;
+    Type type;
+  };
+
+  static const uint32_t VERSION = 1;
+
+  /**
+   * @brief Opens @p file and writes the schema, check isOpen() before use
+   */
+  ColumnarWriter(const std::string& file, const std::vector<Column>& columns,
+                 size_t rowGroupSize = 65536);
+
+  /**
+   * @brief Writes the last row group and closes the file
+   */
+  ~ColumnarWriter();
+
+  bool
+  isOpen() const
+  {
+    return m_file != nullptr;
+  }
+
+  /**
+   * @brief Sets a value of the current row, every column must be set once per row
+   */
+  void
+  set(size_t column, int64_t value);
+
+  void
+  set(size_t column, double value);
+
+  void
+  set(size_t column, const std::string& value);
+
+  /**
+   * @brief Completes the current row, writes a row group when it is full
+   */
+  void
+  endRow();
+
+  /**
+   * @brief Writes the collected rows as a row group
+   */
+  void
+  flush();
+
+  /**
+   * @brief Writes tab-separated @p rows to @p file as a columnar table
+   *
+   * The type of each column is INT64 if all values are integers, DOUBLE if all are numbers
+   * and STRING otherwise. Meant for the small TSV tables of the scenarios.
+   */
+  static bool
+  writeTable(const std::string& file, const std::vector<std::string>& header,
+             const std::vector<std::string>& rows);
+
+private:
+  struct ColumnData
+  {
+    std::vector<int64_t> ints;    ///< INT64 values or STRING ids
+    std::vector<double> doubles;
+    std::unordered_map<std::string, int64_t> dictionary;
+    std::vector<std::string> entries;       ///< dictionary in id order
+  };
+
+  void
+  writeColumn(const Column& column, ColumnData& data, size_t nRows);
+
+  void
+  encodeInts(const std::vector<int64_t>& values);
+
+  static void
+  appendVarint(std::vector<uint8_t>& out, uint64_t value);
+
+  static void
+  appendZigzag(std::vector<uint8_t>& out, int64_t value)
+  {
+    appendVarint(out, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+  }
+
+  void
+  write(const std::vector<uint8_t>& bytes);
+
+private:
+  FILE* m_file;
+  std::vector<Column> m_columns;
+  std::vector<ColumnData> m_data;
+  size_t m_rowGroupSize;
+  size_t m_nRows;
+
+  // scratch buffers, reused for every column
+  std::vector<uint8_t> m_out;
+  std::vector<uint8_t> m_candidate;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // COLUMNAR_WRITER_H
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "forwarder-counters-tracer.hpp"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include "fw/forwarder.hpp"
+#include "fw/push-counters.hpp"
+
+#include <list>
+
+NS_LOG_COMPONENT_DEFINE("ndn.ForwarderCountersTracer");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(ForwarderCountersTracer);
+
+static std::list<Ptr<ForwarderCountersTracer>> g_tracers;
+
+TypeId
+ForwarderCountersTracer::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::ForwarderCountersTracer")
+      .SetGroupName("Ndn")
+      .SetParent<Object>()
+      .AddConstructor<ForwarderCountersTracer>()
+
+      .AddTraceSource("ForwarderCounters",
+                      "Cumulative forwarder counters of a node, sampled periodically",
+                      MakeTraceSourceAccessor(&ForwarderCountersTracer::m_forwarderCounters),
+                      "ns3::ndn::ForwarderCountersTracer::ForwarderCountersCallback");
+
+  return tid;
+}
+
+Ptr<ForwarderCountersTracer>
+ForwarderCountersTracer::Install(const NodeContainer& nodes, Time period)
+{
+  Ptr<ForwarderCountersTracer> tracer = CreateObject<ForwarderCountersTracer>();
+  tracer->SetNodes(nodes);
+  tracer->SetPeriod(period);
+  g_tracers.push_back(tracer);
+  return tracer;
+}
+
+void
+ForwarderCountersTracer::Destroy()
+{
+  g_tracers.clear();
+}
+
+ForwarderCountersTracer::ForwarderCountersTracer()
+  : m_period(Seconds(1.0))
+{
+}
+
+ForwarderCountersTracer::~ForwarderCountersTracer()
+{
+  m_sampleEvent.Cancel();
+}
+
+void
+ForwarderCountersTracer::SetNodes(const NodeContainer& nodes)
+{
+  m_nodes = nodes;
+}
+
+void
+ForwarderCountersTracer::SetPeriod(Time period)
+{
+  m_period = period;
+  m_sampleEvent.Cancel();
+  m_sampleEvent = Simulator::Schedule(m_period, &ForwarderCountersTracer::PeriodicSample, this);
+}
+
+void
+ForwarderCountersTracer::PeriodicSample()
+{
+  SampleAll();
+  m_sampleEvent = Simulator::Schedule(m_period, &ForwarderCountersTracer::PeriodicSample, this);
+}
+
+void
+ForwarderCountersTracer::SampleAll()
+{
+  Time now = Simulator::Now();
+  for (NodeContainer::Iterator node = m_nodes.Begin(); node != m_nodes.End(); ++node) {
+    Ptr<L3Protocol> l3 = (*node)->GetObject<L3Protocol>();
+    if (l3 == nullptr) {
+      continue;
+    }
+
+    const nfd::Forwarder& forwarder = *l3->getForwarder();
+    const nfd::ForwarderCounters& counters = forwarder.getCounters();
+    const nfd::fw::PushCounters& pushCounters = forwarder.getPushCounters();
+
+    Sample sample;
+    sample.nodeId = (*node)->GetId();
+    sample.nInInterests = counters.nInInterests;
+    sample.nOutInterests = counters.nOutInterests;
+    sample.nInData = counters.nInData;
+    sample.nOutData = counters.nOutData;
+    sample.nInNacks = counters.nInNacks;
+    sample.nOutNacks = counters.nOutNacks;
+    sample.nLoopingDrops = pushCounters.nLoopingDrops;
+    sample.nBitvectorWindowMisses = pushCounters.nBitvectorWindowMisses;
+    sample.nDuplicateDeliveries = pushCounters.nDuplicateDeliveries;
+
+    m_forwarderCounters(now, sample);
+  }
+}
+
+} // namespace ndn
+} // namespace ns3
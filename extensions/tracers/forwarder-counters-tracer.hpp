@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef FORWARDER_COUNTERS_TRACER_H
+#define FORWARDER_COUNTERS_TRACER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/node-container.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Periodically samples the forwarder counters of a set of nodes
+ *
+ * Every period, the "ForwarderCounters" trace source is invoked once per node with the
+ * cumulative counters of its forwarder, including the loop prevention counters for
+ * Persistent Interests. Scenarios can aggregate the samples in memory instead of tracing
+ * every packet.
+ */
+class ForwarderCountersTracer : public Object
+{
+public:
+  struct Sample
+  {
+    uint32_t nodeId;
+    uint64_t nInInterests;
+    uint64_t nOutInterests;
+    uint64_t nInData;
+    uint64_t nOutData;
+    uint64_t nInNacks;
+    uint64_t nOutNacks;
+    uint64_t nLoopingDrops;          ///< push Data dropped by the bitvector
+    uint64_t nBitvectorWindowMisses; ///< push Data older than the bitvector window
+    uint64_t nDuplicateDeliveries;   ///< push Data forwarded again despite the bitvector
+  };
+
+  typedef void (*ForwarderCountersCallback)(Time time, const Sample& sample);
+
+  static TypeId
+  GetTypeId();
+
+  /**
+   * @brief Creates a tracer sampling the forwarders of @p nodes every @p period
+   *
+   * The tracer is kept alive until Destroy() is called.
+   */
+  static Ptr<ForwarderCountersTracer>
+  Install(const NodeContainer& nodes, Time period = Seconds(1.0));
+
+  /**
+   * @brief Explicit request to remove all statically created tracers
+   */
+  static void
+  Destroy();
+
+  ForwarderCountersTracer();
+
+  virtual
+  ~ForwarderCountersTracer();
+
+  void
+  SetNodes(const NodeContainer& nodes);
+
+  void
+  SetPeriod(Time period);
+
+  /**
+   * @brief Invokes the trace source for every node immediately
+   */
+  void
+  SampleAll();
+
+private:
+  void
+  PeriodicSample();
+
+private:
+  NodeContainer m_nodes;
+  Time m_period;
+  EventId m_sampleEvent;
+
+  TracedCallback<Time, const Sample&> m_forwarderCounters;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // FORWARDER_COUNTERS_TRACER_H
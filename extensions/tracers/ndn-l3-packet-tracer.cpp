@@ -28,6 +28,8 @@
 
 #include "daemon/table/pit-entry.hpp"
 
+#include "../utils/mpi-partition.hpp"
+
 #include <fstream>
 #include <boost/lexical_cast.hpp>
 
@@ -39,10 +41,33 @@ namespace ndn {
 static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<L3PacketTracer>>>>
   g_tracers;
 
+static std::list<std::tuple<shared_ptr<BinaryTraceWriter>, std::list<Ptr<L3PacketTracer>>>>
+  g_binaryTracers;
+
+static std::list<std::tuple<shared_ptr<ColumnarWriter>, std::list<Ptr<L3PacketTracer>>>>
+  g_columnarTracers;
+
+static shared_ptr<const TraceFilter> g_filter;
+
+// nodes of other MPI ranks are never traced by this rank
+static bool
+isFilteredOut(Ptr<Node> node)
+{
+  return !MpiPartition::IsLocal(node) || (g_filter != nullptr && !g_filter->acceptsNode(node));
+}
+
+void
+L3PacketTracer::SetFilter(shared_ptr<const TraceFilter> filter)
+{
+  g_filter = filter;
+}
+
 void
 L3PacketTracer::Destroy()
 {
   g_tracers.clear();
+  g_binaryTracers.clear();
+  g_columnarTracers.clear();
 }
 
 void
@@ -66,6 +91,9 @@ L3PacketTracer::InstallAll(const std::string& file)
   }
 
   for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    if (isFilteredOut(*node)) {
+      continue;
+    }
     Ptr<L3PacketTracer> trace = Install(*node, outputStream);
     tracers.push_back(trace);
   }
@@ -79,6 +107,77 @@ L3PacketTracer::InstallAll(const std::string& file)
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
 }
 
+void
+L3PacketTracer::InstallAll(shared_ptr<TraceSink> sink)
+{
+  std::list<Ptr<L3PacketTracer>> tracers;
+  shared_ptr<std::ostream> outputStream = sink->getStream();
+
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    if (isFilteredOut(*node)) {
+      continue;
+    }
+    Ptr<L3PacketTracer> trace = Install(*node, outputStream);
+    tracers.push_back(trace);
+  }
+
+  if (tracers.size() > 0) {
+    tracers.front()->PrintHeader(*outputStream);
+    *outputStream << "\n";
+  }
+
+  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+}
+
+void
+L3PacketTracer::InstallAllBinary(const std::string& file)
+{
+  std::list<Ptr<L3PacketTracer>> tracers;
+  shared_ptr<BinaryTraceWriter> writer = make_shared<BinaryTraceWriter>(file);
+  if (!writer->isOpen()) {
+    NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+    return;
+  }
+
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    if (isFilteredOut(*node)) {
+      continue;
+    }
+    NS_LOG_DEBUG("Node: " << (*node)->GetId());
+    tracers.push_back(Create<L3PacketTracer>(writer, *node));
+  }
+
+  g_binaryTracers.push_back(std::make_tuple(writer, tracers));
+}
+
+void
+L3PacketTracer::InstallAllColumnar(const std::string& file)
+{
+  std::list<Ptr<L3PacketTracer>> tracers;
+  shared_ptr<ColumnarWriter> columns = make_shared<ColumnarWriter>(file,
+    std::vector<ColumnarWriter::Column>{{"TimeNs", ColumnarWriter::INT64},
+                                        {"Node", ColumnarWriter::STRING},
+                                        {"FaceId", ColumnarWriter::INT64},
+                                        {"FaceDescr", ColumnarWriter::STRING},
+                                        {"Type", ColumnarWriter::STRING},
+                                        {"Name", ColumnarWriter::STRING},
+                                        {"Bytes", ColumnarWriter::INT64}});
+  if (!columns->isOpen()) {
+    NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+    return;
+  }
+
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    if (isFilteredOut(*node)) {
+      continue;
+    }
+    NS_LOG_DEBUG("Node: " << (*node)->GetId());
+    tracers.push_back(Create<L3PacketTracer>(columns, *node));
+  }
+
+  g_columnarTracers.push_back(std::make_tuple(columns, tracers));
+}
+
 void
 L3PacketTracer::Install(const NodeContainer& nodes, const std::string& file)
 {
@@ -103,6 +202,9 @@ L3PacketTracer::Install(const NodeContainer& nodes, const std::string& file)
   }
 
   for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    if (isFilteredOut(*node)) {
+      continue;
+    }
     Ptr<L3PacketTracer> trace = Install(*node, outputStream);
     tracers.push_back(trace);
   }
@@ -139,8 +241,10 @@ L3PacketTracer::Install(Ptr<Node> node, const std::string& file)
     outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
   }
 
-  Ptr<L3PacketTracer> trace = Install(node, outputStream);
-  tracers.push_back(trace);
+  if (!isFilteredOut(node)) {
+    Ptr<L3PacketTracer> trace = Install(node, outputStream);
+    tracers.push_back(trace);
+  }
 
   if (tracers.size() > 0) {
     // *m_l3RateTrace << "# "; // not necessary for R's read.table
@@ -164,12 +268,32 @@ L3PacketTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream)
 L3PacketTracer::L3PacketTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
   : L3Tracer(node)
   , m_os(os)
+  , m_filter(g_filter)
+  , m_nodeStringId(0)
 {
 }
 
 L3PacketTracer::L3PacketTracer(shared_ptr<std::ostream> os, const std::string& node)
   : L3Tracer(node)
   , m_os(os)
+  , m_filter(g_filter)
+  , m_nodeStringId(0)
+{
+}
+
+L3PacketTracer::L3PacketTracer(shared_ptr<BinaryTraceWriter> writer, Ptr<Node> node)
+  : L3Tracer(node)
+  , m_writer(writer)
+  , m_filter(g_filter)
+{
+  m_nodeStringId = m_writer->getStringId(m_node);
+}
+
+L3PacketTracer::L3PacketTracer(shared_ptr<ColumnarWriter> columns, Ptr<Node> node)
+  : L3Tracer(node)
+  , m_columns(columns)
+  , m_filter(g_filter)
+  , m_nodeStringId(0)
 {
 }
 
@@ -216,40 +340,80 @@ L3PacketTracer::printLog(uint32_t faceId, std::string faceDescr, std::string typ
   *m_os << type << "\t" << name << "\t" << kilobytes << "\n";           
 }
 
+void
+L3PacketTracer::logPacket(const Face& face, BinaryTraceWriter::PacketType type, const Name& name,
+                          size_t bytes)
+{
+  static const char* typeNames[] = {"InInterest", "OutInterest", "InData", "OutData",
+                                     "InNack", "OutNack"};
+
+  if (m_filter != nullptr && !m_filter->accepts(static_cast<TraceFilter::PacketType>(type), name)) {
+    return;
+  }
+
+  if (m_columns != nullptr) {
+    m_columns->set(0, static_cast<int64_t>(Simulator::Now().GetNanoSeconds()));
+    m_columns->set(1, m_node);
+    m_columns->set(2, static_cast<int64_t>(face.getId()));
+    m_columns->set(3, face.getLocalUri().toString());
+    m_columns->set(4, std::string(typeNames[type]));
+    m_columns->set(5, name.toUri());
+    m_columns->set(6, static_cast<int64_t>(bytes));
+    m_columns->endRow();
+    return;
+  }
+
+  if (m_writer == nullptr) {
+    this->printLog(face.getId(), face.getLocalUri().toString(), typeNames[type], name.toUri(), (uint32_t)bytes);
+    return;
+  }
+
+  auto faceDescr = m_faceDescrIds.find(face.getId());
+  if (faceDescr == m_faceDescrIds.end()) {
+    uint32_t id = m_writer->getStringId(face.getLocalUri().toString());
+    faceDescr = m_faceDescrIds.emplace(face.getId(), id).first;
+  }
+
+  m_writer->writePacket(Simulator::Now().GetNanoSeconds(), m_nodeStringId, face.getId(),
+                        faceDescr->second, type, m_writer->getNameId(name), bytes);
+}
+
 void
 L3PacketTracer::OutInterests(const Interest& interest, const Face& face)
 {
-  this->printLog(face.getId(), face.getLocalUri().toString(), "OutInterest", interest.getName().toUri(), (uint32_t)interest.wireEncode().size());
+  this->logPacket(face, BinaryTraceWriter::OUT_INTEREST, interest.getName(), interest.wireEncode().size());
 }
 
 void
 L3PacketTracer::InInterests(const Interest& interest, const Face& face)
 {
-  this->printLog(face.getId(), face.getLocalUri().toString(), "InInterest", interest.getName().toUri(), (uint32_t)interest.wireEncode().size());
+  this->logPacket(face, BinaryTraceWriter::IN_INTEREST, interest.getName(), interest.wireEncode().size());
 }
 
 void
 L3PacketTracer::OutData(const Data& data, const Face& face)
 {
-  this->printLog(face.getId(), face.getLocalUri().toString(), "OutData", data.getName().toUri(), (uint32_t)data.wireEncode().size());
+  this->logPacket(face, BinaryTraceWriter::OUT_DATA, data.getName(), data.wireEncode().size());
 }
 
 void
 L3PacketTracer::InData(const Data& data, const Face& face)
 {
-  this->printLog(face.getId(), face.getLocalUri().toString(), "InData", data.getName().toUri(), (uint32_t)data.wireEncode().size());
+  this->logPacket(face, BinaryTraceWriter::IN_DATA, data.getName(), data.wireEncode().size());
 }
 
 void
 L3PacketTracer::OutNack(const lp::Nack& nack, const Face& face)
 {
-  // todo: Implement Nack method
+  this->logPacket(face, BinaryTraceWriter::OUT_NACK, nack.getInterest().getName(),
+                  nack.getInterest().wireEncode().size());
 }
 
 void
 L3PacketTracer::InNack(const lp::Nack& nack, const Face& face)
 {
-  // todo: Implement Nack method
+  this->logPacket(face, BinaryTraceWriter::IN_NACK, nack.getInterest().getName(),
+                  nack.getInterest().wireEncode().size());
 }
 
 void
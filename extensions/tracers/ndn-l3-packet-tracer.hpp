@@ -24,6 +24,11 @@
 
 #include "ns3/ndnSIM/utils/tracers/ndn-l3-tracer.hpp"
 
+#include "binary-trace-writer.hpp"
+#include "columnar-writer.hpp"
+#include "trace-filter.hpp"
+#include "trace-sink.hpp"
+
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 #include "ns3/node-container.h"
@@ -31,6 +36,7 @@
 #include <tuple>
 #include <map>
 #include <list>
+#include <unordered_map>
 
 namespace ns3 {
 namespace ndn {
@@ -52,6 +58,34 @@ public:
   static void
   InstallAll(const std::string& file);
 
+  /**
+   * @brief Helper method to install tracers on all simulation nodes writing to @p sink
+   *
+   * @param sink Sink shared with other tracers, e.g. an AsyncTraceSink
+   */
+  static void
+  InstallAll(shared_ptr<TraceSink> sink);
+
+  /**
+   * @brief Helper method to install tracers writing the binary trace format on all nodes
+   *
+   * Use convert-trace.py to convert the file to the format written by InstallAll.
+   *
+   * @param file File to which traces will be written
+   */
+  static void
+  InstallAllBinary(const std::string& file);
+
+  /**
+   * @brief Helper method to install tracers writing a columnar trace on all nodes
+   *
+   * Columns: TimeNs, Node, FaceId, FaceDescr, Type, Name, Bytes
+   *
+   * @param file File to which traces will be written
+   */
+  static void
+  InstallAllColumnar(const std::string& file);
+
   /**
    * @brief Helper method to install tracers on the selected simulation nodes
    *
@@ -74,6 +108,15 @@ public:
   static void
   Install(Ptr<Node> node, const std::string& file);
 
+  /**
+   * @brief Sets the filter of the tracers installed afterwards
+   *
+   * Nodes rejected by the filter get no tracer, the tracers of the other nodes only record
+   * the packets accepted by the filter. Pass nullptr to trace everything again.
+   */
+  static void
+  SetFilter(shared_ptr<const TraceFilter> filter);
+
   /**
    * @brief Explicit request to remove all statically created tracers
    *
@@ -97,6 +140,20 @@ public:
    */
   L3PacketTracer(shared_ptr<std::ostream> os, const std::string& node);
 
+  /**
+   * @brief Trace constructor that writes binary records
+   * @param writer  shared writer of all tracers
+   * @param node    pointer to the node
+   */
+  L3PacketTracer(shared_ptr<BinaryTraceWriter> writer, Ptr<Node> node);
+
+  /**
+   * @brief Trace constructor that writes to columnar trace
+   * @param columns  shared writer of all tracers
+   * @param node     pointer to the node
+   */
+  L3PacketTracer(shared_ptr<ColumnarWriter> columns, Ptr<Node> node);
+
   /**
    * @brief Destructor
    */
@@ -151,11 +208,19 @@ protected:
   TimedOutInterests(const nfd::pit::Entry&);
 
 private:
+  void
+  logPacket(const Face& face, BinaryTraceWriter::PacketType type, const Name& name, size_t bytes);
+
   virtual void
   printLog(uint32_t faceId, std::string faceDescr, std::string type, std::string name, uint32_t kilobytes);
 
 private:
   shared_ptr<std::ostream> m_os;
+  shared_ptr<BinaryTraceWriter> m_writer;
+  shared_ptr<ColumnarWriter> m_columns;
+  shared_ptr<const TraceFilter> m_filter;
+  uint32_t m_nodeStringId;
+  std::unordered_map<uint32_t, uint32_t> m_faceDescrIds;
   Time m_period;
   EventId m_printEvent;
 };
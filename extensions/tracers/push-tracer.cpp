@@ -31,7 +31,11 @@
 
 #include "ns3/ndnSIM/ndn-cxx/lp/tags.hpp"
 
+#include "../utils/mpi-partition.hpp"
+
 #include <fstream>
+#include <algorithm>
+#include <cstring>
 #include <boost/lexical_cast.hpp>
 
 NS_LOG_COMPONENT_DEFINE("ndn.PushTracer");
@@ -39,13 +43,36 @@ NS_LOG_COMPONENT_DEFINE("ndn.PushTracer");
 namespace ns3 {
 namespace ndn {
 
+const size_t PushTracer::N_HOP_COUNT_BINS;
+const size_t PushTracer::SEQ_WINDOW;
+const size_t PushTracer::SEQ_WINDOW_WORDS;
+
 static std::list<std::tuple<shared_ptr<std::ostream>, std::list<Ptr<PushTracer>>>>
   g_tracers;
 
+static std::list<std::tuple<shared_ptr<ColumnarWriter>, std::list<Ptr<PushTracer>>>>
+  g_columnarTracers;
+
+static shared_ptr<const TraceFilter> g_filter;
+
+// nodes of other MPI ranks are never traced by this rank
+static bool
+isFilteredOut(Ptr<Node> node)
+{
+  return !MpiPartition::IsLocal(node) || (g_filter != nullptr && !g_filter->acceptsNode(node));
+}
+
+void
+PushTracer::SetFilter(shared_ptr<const TraceFilter> filter)
+{
+  g_filter = filter;
+}
+
 void
 PushTracer::Destroy()
 {
   g_tracers.clear();
+  g_columnarTracers.clear();
 }
 
 void
@@ -69,6 +96,9 @@ PushTracer::InstallAll(const std::string& file, Time averagingPeriod /* = Second
   }
 
   for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    if (isFilteredOut(*node)) {
+      continue;
+    }
     Ptr<PushTracer> trace = Install(*node, outputStream, averagingPeriod);
     tracers.push_back(trace);
   }
@@ -107,6 +137,9 @@ PushTracer::Install(const NodeContainer& nodes, const std::string& file,
   }
 
   for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    if (isFilteredOut(*node)) {
+      continue;
+    }
     Ptr<PushTracer> trace = Install(*node, outputStream, averagingPeriod);
     tracers.push_back(trace);
   }
@@ -120,6 +153,28 @@ PushTracer::Install(const NodeContainer& nodes, const std::string& file,
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
 }
 
+void
+PushTracer::Install(const NodeContainer& nodes, shared_ptr<TraceSink> sink, Time averagingPeriod)
+{
+  std::list<Ptr<PushTracer>> tracers;
+  shared_ptr<std::ostream> outputStream = sink->getStream();
+
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    if (isFilteredOut(*node)) {
+      continue;
+    }
+    Ptr<PushTracer> trace = Install(*node, outputStream, averagingPeriod);
+    tracers.push_back(trace);
+  }
+
+  if (tracers.size() > 0) {
+    tracers.front()->PrintHeader(*outputStream);
+    *outputStream << "\n";
+  }
+
+  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+}
+
 void
 PushTracer::Install(Ptr<Node> node, const std::string& file,
                       Time averagingPeriod /* = Seconds (0.5)*/)
@@ -144,8 +199,10 @@ PushTracer::Install(Ptr<Node> node, const std::string& file,
     outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
   }
 
-  Ptr<PushTracer> trace = Install(node, outputStream, averagingPeriod);
-  tracers.push_back(trace);
+  if (!isFilteredOut(node)) {
+    Ptr<PushTracer> trace = Install(node, outputStream, averagingPeriod);
+    tracers.push_back(trace);
+  }
 
   if (tracers.size() > 0) {
     // *m_l3RateTrace << "# "; // not necessary for R's read.table
@@ -156,6 +213,74 @@ PushTracer::Install(Ptr<Node> node, const std::string& file,
   g_tracers.push_back(std::make_tuple(outputStream, tracers));
 }
 
+void
+PushTracer::InstallAggregated(const NodeContainer& nodes, const std::string& file, Time period)
+{
+  std::list<Ptr<PushTracer>> tracers;
+  shared_ptr<std::ostream> outputStream;
+  if (file != "-") {
+    shared_ptr<std::ofstream> os(new std::ofstream());
+    os->open(file.c_str(), std::ios_base::out | std::ios_base::trunc);
+
+    if (!os->is_open()) {
+      NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+      return;
+    }
+
+    outputStream = os;
+  }
+  else {
+    outputStream = shared_ptr<std::ostream>(&std::cout, std::bind([]{}));
+  }
+
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    if (isFilteredOut(*node)) {
+      continue;
+    }
+    NS_LOG_DEBUG("Node: " << (*node)->GetId());
+    Ptr<PushTracer> trace = Create<PushTracer>(outputStream, *node);
+    trace->m_isAggregated = true;
+    trace->SetAveragingPeriod(period);
+    tracers.push_back(trace);
+  }
+
+  if (tracers.size() > 0) {
+    tracers.front()->PrintAggregatedHeader(*outputStream);
+    *outputStream << "\n";
+  }
+
+  g_tracers.push_back(std::make_tuple(outputStream, tracers));
+}
+
+void
+PushTracer::InstallColumnar(const NodeContainer& nodes, const std::string& file)
+{
+  std::list<Ptr<PushTracer>> tracers;
+  shared_ptr<ColumnarWriter> columns = make_shared<ColumnarWriter>(file,
+    std::vector<ColumnarWriter::Column>{{"TimeNs", ColumnarWriter::INT64},
+                                        {"Node", ColumnarWriter::INT64},
+                                        {"Type", ColumnarWriter::STRING},
+                                        {"Name", ColumnarWriter::STRING},
+                                        {"SeqNo", ColumnarWriter::INT64},
+                                        {"HopCount", ColumnarWriter::INT64}});
+  if (!columns->isOpen()) {
+    NS_LOG_ERROR("File " << file << " cannot be opened for writing. Tracing disabled");
+    return;
+  }
+
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); node++) {
+    if (isFilteredOut(*node)) {
+      continue;
+    }
+    NS_LOG_DEBUG("Node: " << (*node)->GetId());
+    Ptr<PushTracer> trace = Create<PushTracer>(shared_ptr<std::ostream>(), *node);
+    trace->m_columns = columns;
+    tracers.push_back(trace);
+  }
+
+  g_columnarTracers.push_back(std::make_tuple(columns, tracers));
+}
+
 Ptr<PushTracer>
 PushTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream,
                       Time averagingPeriod /* = Seconds (0.5)*/)
@@ -171,20 +296,25 @@ PushTracer::Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream,
 PushTracer::PushTracer(shared_ptr<std::ostream> os, Ptr<Node> node)
   : L3Tracer(node)
   , m_os(os)
+  , m_filter(g_filter)
+  , m_period(Seconds(1.0))
+  , m_isAggregated(false)
 {
-  SetAveragingPeriod(Seconds(1.0));
 }
 
 PushTracer::PushTracer(shared_ptr<std::ostream> os, const std::string& node)
   : L3Tracer(node)
   , m_os(os)
+  , m_filter(g_filter)
+  , m_period(Seconds(1.0))
+  , m_isAggregated(false)
 {
-  SetAveragingPeriod(Seconds(1.0));
 }
 
 PushTracer::~PushTracer()
 {
   m_printEvent.Cancel();
+  m_flushEvent.Cancel();
 }
 
 void
@@ -192,7 +322,15 @@ PushTracer::SetAveragingPeriod(const Time& period)
 {
   m_period = period;
   m_printEvent.Cancel();
-  m_printEvent = Simulator::Schedule(m_period, &PushTracer::PeriodicPrinter, this);
+
+  // per-packet lines are written immediately, there is nothing to print periodically
+  if (m_isAggregated) {
+    m_printEvent = Simulator::Schedule(m_period, &PushTracer::PeriodicPrinter, this);
+
+    // Simulator::Destroy still runs at the time of the last event, print the partial period then
+    m_flushEvent.Cancel();
+    m_flushEvent = Simulator::ScheduleDestroy(&PushTracer::FlushPeriod, this);
+  }
 }
 
 void
@@ -204,6 +342,14 @@ PushTracer::PeriodicPrinter()
   m_printEvent = Simulator::Schedule(m_period, &PushTracer::PeriodicPrinter, this);
 }
 
+void
+PushTracer::FlushPeriod()
+{
+  m_printEvent.Cancel();
+  Print(*m_os);
+  Reset();
+}
+
 void
 PushTracer::PrintHeader(std::ostream& os) const
 {
@@ -221,15 +367,78 @@ PushTracer::PrintHeader(std::ostream& os) const
      << "";
 }
 
+void
+PushTracer::PrintAggregatedHeader(std::ostream& os) const
+{
+  os << "Time"
+     << "\t"
+     << "Node"
+     << "\t"
+     << "Prefix"
+     << "\t"
+     << "InInterests"
+     << "\t"
+     << "OutInterests"
+     << "\t"
+     << "Sent"
+     << "\t"
+     << "OutData"
+     << "\t"
+     << "Received"
+     << "\t"
+     << "Duplicates"
+     << "\t"
+     << "Lost"
+     << "\t"
+     << "Late"
+     << "\t"
+     << "MeanHopCount"
+     << "\t"
+     << "HopCounts";
+}
+
 void
 PushTracer::Reset()
 {
+  std::fill(m_counters.begin(), m_counters.end(), 0);
+  std::fill(m_hopCounts.begin(), m_hopCounts.end(), 0);
 }
 
 void PushTracer::Print(std::ostream& os) const
 {
   Time time = Simulator::Now();
 
+  for (size_t prefix = 0; prefix < m_prefixes.size(); prefix++) {
+    const uint64_t* counters = &m_counters[prefix * N_COUNTERS];
+    if (std::all_of(counters, counters + N_COUNTERS, [] (uint64_t value) { return value == 0; })) {
+      continue;
+    }
+
+    os << time.ToDouble(Time::S) << "\t"
+       << m_nodePtr->GetId() << "\t"
+       << m_prefixes[prefix] << "\t"
+       << counters[IN_INTERESTS] << "\t"
+       << counters[OUT_INTERESTS] << "\t"
+       << counters[SENT] << "\t"
+       << counters[OUT_DATA] << "\t"
+       << counters[RECEIVED] << "\t"
+       << counters[DUPLICATES] << "\t"
+       << counters[LOST] << "\t"
+       << counters[LATE] << "\t"
+       << (counters[RECEIVED] == 0 ? 0.0 : (double)counters[HOP_COUNT_SUM] / counters[RECEIVED]) << "\t";
+
+    // histogram up to the largest hop count seen, e.g. "0,0,3,12,1"
+    const uint64_t* hopCounts = &m_hopCounts[prefix * N_HOP_COUNT_BINS];
+    size_t nBins = N_HOP_COUNT_BINS;
+    while (nBins > 1 && hopCounts[nBins - 1] == 0) {
+      nBins--;
+    }
+    for (size_t bin = 0; bin < nBins; bin++) {
+      os << (bin == 0 ? "" : ",") << hopCounts[bin];
+    }
+    os << "\n";
+  }
+
   /*for(PrefixTracerMap::const_iterator pit = prefixMap.begin (); pit != prefixMap.end (); pit++)
   {
     for(FaceMap::const_iterator fit = pit->second.begin(); fit != pit->second.end(); fit++)
@@ -268,10 +477,129 @@ void PushTracer::OutInterests(const Interest& interest, const Face& face)
 {
 }
 
+void
+PushTracer::printPacket(const char* type, const Name& name, uint32_t seq, int hopCount)
+{
+  if (m_columns != nullptr) {
+    m_columns->set(0, static_cast<int64_t>(Simulator::Now().GetNanoSeconds()));
+    m_columns->set(1, static_cast<int64_t>(m_nodePtr->GetId()));
+    m_columns->set(2, std::string(type));
+    m_columns->set(3, name.toUri());
+    m_columns->set(4, static_cast<int64_t>(seq));
+    m_columns->set(5, static_cast<int64_t>(hopCount));
+    m_columns->endRow();
+    return;
+  }
+
+  *m_os << Simulator::Now().ToDouble(Time::S) << "\t"
+        << m_nodePtr->GetId() << "\t"
+        << type << "\t"
+        << name << "\t"
+        << seq << "\t"
+        << hopCount << "\t"
+        << "\n";
+}
+
+bool
+PushTracer::isPushName(const Name& name)
+{
+  // same as name.toUri().find("voip"), without formatting the name
+  static const char voip[] = "voip";
+  for (const ::ndn::name::Component& component : name) {
+    if (std::search(component.value_begin(), component.value_end(),
+                    voip, voip + std::strlen(voip)) != component.value_end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t
+PushTracer::getPrefixIndex(const Name& name, size_t prefixLength)
+{
+  // a node only sees a handful of push prefixes, a linear scan is cheaper than a map lookup
+  for (size_t prefix = 0; prefix < m_prefixes.size(); prefix++) {
+    if (m_prefixes[prefix].size() == prefixLength &&
+        m_prefixes[prefix].compare(0, prefixLength, name, 0, prefixLength) == 0) {
+      return prefix;
+    }
+  }
+
+  m_prefixes.push_back(name.getPrefix(prefixLength));
+  m_counters.resize(m_counters.size() + N_COUNTERS, 0);
+  m_hopCounts.resize(m_hopCounts.size() + N_HOP_COUNT_BINS, 0);
+  m_delivered.resize(m_delivered.size() + SEQ_WINDOW_WORDS, 0);
+  m_firstSeq.push_back(0);
+  m_highestSeq.push_back(0);
+  m_hasSeq.push_back(false);
+  return m_prefixes.size() - 1;
+}
+
+void
+PushTracer::recordReceived(size_t prefix, uint64_t seq, int hopCount)
+{
+  count(prefix, HOP_COUNT_SUM, hopCount);
+  m_hopCounts[prefix * N_HOP_COUNT_BINS + std::min<size_t>(hopCount, N_HOP_COUNT_BINS - 1)]++;
+
+  uint64_t* window = &m_delivered[prefix * SEQ_WINDOW_WORDS];
+  auto bit = [window] (uint64_t s) -> bool { return window[(s % SEQ_WINDOW) / 64] & (1ULL << (s % 64)); };
+  auto setBit = [window] (uint64_t s) { window[(s % SEQ_WINDOW) / 64] |= 1ULL << (s % 64); };
+  auto clearBit = [window] (uint64_t s) { window[(s % SEQ_WINDOW) / 64] &= ~(1ULL << (s % 64)); };
+
+  if (!m_hasSeq[prefix]) {
+    m_hasSeq[prefix] = true;
+    m_firstSeq[prefix] = seq;
+    m_highestSeq[prefix] = seq;
+    setBit(seq);
+    count(prefix, RECEIVED);
+    return;
+  }
+
+  uint64_t highest = m_highestSeq[prefix];
+  if (seq > highest) {
+    // slide the window, sequence numbers leaving it without being received are lost
+    uint64_t advance = seq - highest;
+    if (advance >= uint64_t(SEQ_WINDOW)) {
+      // the whole old window leaves, as do the skipped numbers below the new window
+      uint64_t oldest = highest + 1 >= uint64_t(SEQ_WINDOW) ? highest + 1 - SEQ_WINDOW : 0;
+      for (uint64_t s = std::max(oldest, m_firstSeq[prefix]); s <= highest; s++) {
+        if (!bit(s)) {
+          count(prefix, LOST);
+        }
+      }
+      count(prefix, LOST, advance - SEQ_WINDOW);
+      std::fill(window, window + SEQ_WINDOW_WORDS, 0);
+    }
+    else {
+      for (uint64_t next = highest + 1; next <= seq; next++) {
+        // the slot of next holds next - SEQ_WINDOW if that was part of the old window
+        uint64_t leaving = next - SEQ_WINDOW;
+        if (next >= uint64_t(SEQ_WINDOW) && leaving >= m_firstSeq[prefix] && !bit(next)) {
+          count(prefix, LOST);
+        }
+        clearBit(next);
+      }
+    }
+    m_highestSeq[prefix] = seq;
+    setBit(seq);
+    count(prefix, RECEIVED);
+  }
+  else if (highest - seq >= SEQ_WINDOW || seq < m_firstSeq[prefix]) {
+    // already counted as lost
+    count(prefix, LATE);
+  }
+  else if (bit(seq)) {
+    count(prefix, DUPLICATES);
+  }
+  else {
+    setBit(seq);
+    count(prefix, RECEIVED);
+  }
+}
+
 void PushTracer::InInterests(const Interest& interest, const Face& face)
 {
-  bool voip = interest.getName().toUri().find("voip") != std::string::npos;
-  if (interest.isPush() || interest.isPushRefresh() || voip) {
+  if (interest.isPush() || interest.isPushRefresh() || isPushName(interest.getName())) {
 
     int hopCount = 0;
     
@@ -281,24 +609,28 @@ void PushTracer::InInterests(const Interest& interest, const Face& face)
       NS_LOG_DEBUG("Hop count: " << hopCount);
     }
 
+    if (m_filter != nullptr &&
+        !m_filter->accepts(hopCount == 0 ? TraceFilter::OUT_INTEREST : TraceFilter::IN_INTEREST,
+                           interest.getName())) {
+      return;
+    }
+
+    if (m_isAggregated) {
+      size_t prefix = getPrefixIndex(interest.getName(), interest.getName().size());
+      count(prefix, hopCount == 0 ? OUT_INTERESTS : IN_INTERESTS);
+      return;
+    }
+
     // Todo: Find better distinction between InInterest and OutInterest
     uint32_t seq = 0;
     Name name = interest.getName();
-    *m_os << Simulator::Now().ToDouble(Time::S) << "\t"
-          << m_nodePtr->GetId() << "\t"
-          << (hopCount == 0 ? "OutInterests" : "InInterests") << "\t" 
-          << name << "\t"
-          << seq << "\t"
-          << hopCount << "\t"
-          << "\n";
+    printPacket((hopCount == 0 ? "OutInterests" : "InInterests"), name, seq, hopCount);
   }
 }
 
 void PushTracer::OutData(const Data& data, const Face& face)
 {
-  bool voip = data.getName().toUri().find("voip") != std::string::npos;
-
-  if (data.isPush() || voip) {
+  if (data.isPush() || isPushName(data.getName())) {
     int hopCount = 0;
     
     auto hopCountTag = data.getTag<lp::HopCountTag>();
@@ -307,25 +639,26 @@ void PushTracer::OutData(const Data& data, const Face& face)
       NS_LOG_DEBUG("Hop count: " << hopCount);
     }
 
+    if (m_filter != nullptr && !m_filter->accepts(TraceFilter::OUT_DATA, data.getName())) {
+      return;
+    }
+
+    if (m_isAggregated) {
+      count(getPrefixIndex(data.getName(), data.getName().size() - 1), OUT_DATA);
+      return;
+    }
+
     uint32_t seq = data.getName().at(-1).toSequenceNumber();
 
     Name name = data.getName().getPrefix(data.getName().size() - 1);
 
-    *m_os << Simulator::Now().ToDouble(Time::S) << "\t"
-          << m_nodePtr->GetId() << "\t"
-          << "outData" << "\t" 
-          << name << "\t"
-          << seq << "\t"
-          << hopCount << "\t"
-          << "\n";
+    printPacket("outData", name, seq, hopCount);
   }
 }
 
 void PushTracer::InData(const Data& data, const Face& face)
 {
-  bool voip = data.getName().toUri().find("voip") != std::string::npos;
-
-  if (data.isPush() || voip) {
+  if (data.isPush() || isPushName(data.getName())) {
     int hopCount = 0;
     
     auto hopCountTag = data.getTag<lp::HopCountTag>();
@@ -334,17 +667,26 @@ void PushTracer::InData(const Data& data, const Face& face)
       NS_LOG_DEBUG("Hop count: " << hopCount);
     }
 
+    if (m_filter != nullptr && !m_filter->accepts(TraceFilter::IN_DATA, data.getName())) {
+      return;
+    }
+
+    if (m_isAggregated) {
+      size_t prefix = getPrefixIndex(data.getName(), data.getName().size() - 1);
+      if (hopCount == 0) {
+        count(prefix, SENT);
+      }
+      else {
+        recordReceived(prefix, data.getName().at(-1).toSequenceNumber(), hopCount);
+      }
+      return;
+    }
+
     uint32_t seq = data.getName().at(-1).toSequenceNumber();
 
     Name name = data.getName().getPrefix(data.getName().size() - 1);
 
-    *m_os << Simulator::Now().ToDouble(Time::S) << "\t"
-          << m_nodePtr->GetId() << "\t"
-          << (hopCount == 0 ? "send" : "receive") << "\t" 
-          << name << "\t"
-          << seq << "\t"
-          << hopCount << "\t"
-          << "\n";
+    printPacket((hopCount == 0 ? "send" : "receive"), name, seq, hopCount);
   } 
 }
 
@@ -24,6 +24,10 @@
 
 #include "ns3/ndnSIM/utils/tracers/ndn-l3-tracer.hpp"
 
+#include "columnar-writer.hpp"
+#include "trace-filter.hpp"
+#include "trace-sink.hpp"
+
 #include "ns3/nstime.h"
 #include "ns3/event-id.h"
 #include "ns3/node-container.h"
@@ -35,6 +39,7 @@
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <vector>
 
 
 namespace ns3 {
@@ -68,6 +73,16 @@ public:
   static void
   Install(const NodeContainer& nodes, const std::string& file, Time averagingPeriod = Seconds(0.5));
 
+  /**
+   * @brief Helper method to install tracers on the selected simulation nodes writing to @p sink
+   *
+   * @param nodes Nodes on which to install tracer
+   * @param sink Sink shared with other tracers, e.g. an AsyncTraceSink
+   * @param averagingPeriod How often data will be written into the trace file
+   */
+  static void
+  Install(const NodeContainer& nodes, shared_ptr<TraceSink> sink, Time averagingPeriod = Seconds(0.5));
+
   /**
    * @brief Helper method to install tracers on a specific simulation node
    *
@@ -79,6 +94,41 @@ public:
   static void
   Install(Ptr<Node> node, const std::string& file, Time averagingPeriod = Seconds(0.5));
 
+  /**
+   * @brief Helper method to install tracers that aggregate push traffic in the simulator
+   *
+   * Instead of a line per packet, one summary line per node and prefix is written every
+   * @p period: packet counters, received, duplicate and lost sequence numbers and the
+   * distribution of hop counts of received Data.
+   *
+   * @param nodes Nodes on which to install tracer
+   * @param file File to which traces will be written.  If filename is -, then std::out is used
+   * @param period How often the summary is written
+   */
+  static void
+  InstallAggregated(const NodeContainer& nodes, const std::string& file,
+                    Time period = Seconds(1.0));
+
+  /**
+   * @brief Helper method to install tracers writing a columnar trace
+   *
+   * Same records as Install, columns: TimeNs, Node, Type, Name, SeqNo, HopCount
+   *
+   * @param nodes Nodes on which to install tracer
+   * @param file File to which traces will be written
+   */
+  static void
+  InstallColumnar(const NodeContainer& nodes, const std::string& file);
+
+  /**
+   * @brief Sets the filter of the tracers installed afterwards
+   *
+   * Nodes rejected by the filter get no tracer, the tracers of the other nodes only record
+   * the push packets accepted by the filter. Pass nullptr to trace all push packets again.
+   */
+  static void
+  SetFilter(shared_ptr<const TraceFilter> filter);
+
   /**
    * @brief Explicit request to remove all statically created tracers
    *
@@ -123,6 +173,15 @@ public:
   Install(Ptr<Node> node, shared_ptr<std::ostream> outputStream,
           Time averagingPeriod = Seconds(0.5));
 
+  /**
+   * @brief Whether @p name belongs to a push flow, i.e. contains "voip"
+   *
+   * Used for packets whose push flag is not set, and by the trace replay, which only
+   * knows the names.
+   */
+  static bool
+  isPushName(const Name& name);
+
   // from L3Tracer
   virtual void
   PrintHeader(std::ostream& os) const;
@@ -162,9 +221,54 @@ protected:
   void
   PeriodicPrinter();
 
+  /**
+   * @brief Prints the counters of the last, incomplete averaging period
+   */
+  void
+  FlushPeriod();
+
   void
   Reset();
 
+  void
+  PrintAggregatedHeader(std::ostream& os) const;
+
+private:
+  enum Counter {
+    IN_INTERESTS,
+    OUT_INTERESTS,
+    SENT,
+    OUT_DATA,
+    RECEIVED,
+    DUPLICATES,
+    LOST,
+    LATE,
+    HOP_COUNT_SUM,
+    N_COUNTERS
+  };
+
+  /// number of hop count histogram bins, the last bin counts all larger hop counts
+  static const size_t N_HOP_COUNT_BINS = 32;
+
+  /// sequence numbers tracked per prefix to detect duplicates and losses
+  static const size_t SEQ_WINDOW = 1024;
+  static const size_t SEQ_WINDOW_WORDS = SEQ_WINDOW / 64;
+
+  void
+  printPacket(const char* type, const Name& name, uint32_t seq, int hopCount);
+
+  size_t
+  getPrefixIndex(const Name& name, size_t prefixLength);
+
+  void
+  count(size_t prefix, Counter counter, uint64_t value = 1)
+  {
+    m_counters[prefix * N_COUNTERS + counter] += value;
+  }
+
+  void
+  recordReceived(size_t prefix, uint64_t seq, int hopCount);
+
   /*void checkIfPrefixKnown(const Data& data);
   void checkIfPrefixKnown(const Interest& interest );
   void checkIfPrefixKnown(const Name& name);
@@ -173,8 +277,21 @@ protected:
 
 private:
   shared_ptr<std::ostream> m_os;
+  shared_ptr<ColumnarWriter> m_columns;
+  shared_ptr<const TraceFilter> m_filter;
   Time m_period;
   EventId m_printEvent;
+  EventId m_flushEvent;
+
+  // aggregated mode, all per-prefix state is kept in flat arrays indexed by prefix
+  bool m_isAggregated;
+  std::vector<Name> m_prefixes;
+  std::vector<uint64_t> m_counters;         ///< N_COUNTERS per prefix
+  std::vector<uint64_t> m_hopCounts;        ///< N_HOP_COUNT_BINS per prefix
+  std::vector<uint64_t> m_delivered;        ///< bitmap of SEQ_WINDOW bits per prefix
+  std::vector<uint64_t> m_firstSeq;
+  std::vector<uint64_t> m_highestSeq;
+  std::vector<bool> m_hasSeq;
 
   // mutable std::map<shared_ptr<const Face>, std::tuple<Stats, Stats, Stats, Stats>> m_stats;
 
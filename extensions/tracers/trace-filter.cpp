@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "trace-filter.hpp"
+
+#include "ns3/log.h"
+#include "ns3/names.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE("ndn.TraceFilter");
+
+namespace ns3 {
+namespace ndn {
+
+static const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+static const uint64_t FNV_PRIME = 1099511628211ULL;
+
+static uint64_t
+hashComponent(uint64_t hash, const ::ndn::name::Component& component)
+{
+  hash = (hash ^ component.type()) * FNV_PRIME;
+  hash = (hash ^ component.value_size()) * FNV_PRIME;
+  for (const uint8_t* byte = component.value(); byte != component.value() + component.value_size(); ++byte) {
+    hash = (hash ^ *byte) * FNV_PRIME;
+  }
+  return hash;
+}
+
+static uint64_t
+hashPrefix(const Name& name)
+{
+  uint64_t hash = FNV_OFFSET;
+  for (const ::ndn::name::Component& component : name) {
+    hash = hashComponent(hash, component);
+  }
+  return hash;
+}
+
+// FNV-1a is weak in the low bits, mix before taking the sampling modulo
+static uint64_t
+mix(uint64_t hash)
+{
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+shared_ptr<TraceFilter>
+TraceFilter::compile(const std::string& rules, const std::map<std::string, NodeContainer>& nodeSets)
+{
+  shared_ptr<TraceFilter> filter = make_shared<TraceFilter>();
+
+  std::vector<std::string> clauses;
+  boost::split(clauses, rules, boost::is_any_of(";"), boost::token_compress_on);
+  for (std::string& clause : clauses) {
+    boost::trim(clause);
+    if (clause.empty()) {
+      continue;
+    }
+
+    size_t separator = clause.find('=');
+    if (separator == std::string::npos) {
+      NS_FATAL_ERROR("Trace filter clause '" << clause << "' is not of the form key=value");
+    }
+    std::string key = boost::trim_copy(clause.substr(0, separator));
+    std::vector<std::string> values;
+    boost::split(values, clause.substr(separator + 1), boost::is_any_of(","), boost::token_compress_on);
+    for (std::string& value : values) {
+      boost::trim(value);
+    }
+    values.erase(std::remove(values.begin(), values.end(), ""), values.end());
+    if (values.empty()) {
+      NS_FATAL_ERROR("Trace filter clause '" << clause << "' has no values");
+    }
+
+    if (key == "prefix") {
+      for (const std::string& value : values) {
+        Name prefix(value);
+        if (prefix.size() >= 64) {
+          NS_FATAL_ERROR("Trace filter prefix " << prefix << " has too many components");
+        }
+        filter->m_prefixes.emplace(hashPrefix(prefix), prefix);
+        filter->m_prefixLengths |= 1ULL << prefix.size();
+        filter->m_maxPrefixLength = std::max(filter->m_maxPrefixLength, prefix.size());
+      }
+    }
+    else if (key == "type") {
+      static const char* typeNames[] = {"InInterest", "OutInterest", "InData", "OutData",
+                                         "InNack", "OutNack"};
+      filter->m_typeMask = 0;
+      for (const std::string& value : values) {
+        auto type = std::find(std::begin(typeNames), std::end(typeNames), value);
+        if (type == std::end(typeNames)) {
+          NS_FATAL_ERROR("Unknown packet type '" << value << "' in trace filter");
+        }
+        filter->m_typeMask |= 1 << (type - std::begin(typeNames));
+      }
+    }
+    else if (key == "node") {
+      for (const std::string& value : values) {
+        auto nodeSet = nodeSets.find(value);
+        if (nodeSet != nodeSets.end()) {
+          for (NodeContainer::Iterator node = nodeSet->second.Begin(); node != nodeSet->second.End(); ++node) {
+            filter->m_nodes.insert((*node)->GetId());
+          }
+        }
+        else if (Names::Find<Node>(value) != nullptr) {
+          filter->m_nodes.insert(Names::Find<Node>(value)->GetId());
+        }
+        else if (std::all_of(value.begin(), value.end(), ::isdigit)) {
+          filter->m_nodes.insert(boost::lexical_cast<uint32_t>(value));
+        }
+        else {
+          NS_FATAL_ERROR("Unknown node '" << value << "' in trace filter");
+        }
+      }
+    }
+    else if (key == "sample") {
+      try {
+        filter->m_sampling = boost::lexical_cast<uint64_t>(values.front());
+      }
+      catch (const boost::bad_lexical_cast&) {
+        NS_FATAL_ERROR("Trace filter sampling rate '" << values.front() << "' is not a number");
+      }
+      if (filter->m_sampling == 0 || values.size() > 1) {
+        NS_FATAL_ERROR("Trace filter sampling rate must be a single number >= 1");
+      }
+    }
+    else {
+      NS_FATAL_ERROR("Unknown trace filter clause '" << key << "'");
+    }
+  }
+
+  NS_LOG_DEBUG("Trace filter: " << filter->m_prefixes.size() << " prefixes, type mask "
+               << static_cast<int>(filter->m_typeMask) << ", " << filter->m_nodes.size()
+               << " nodes, sampling 1/" << filter->m_sampling);
+  return filter;
+}
+
+bool
+TraceFilter::acceptsName(const Name& name) const
+{
+  bool isPrefixMatched = m_prefixes.empty();
+  uint64_t hash = FNV_OFFSET;
+  size_t length = 0;
+
+  // the empty prefix has no components
+  if (!isPrefixMatched && (m_prefixLengths & 1) != 0) {
+    isPrefixMatched = true;
+  }
+
+  for (const ::ndn::name::Component& component : name) {
+    hash = hashComponent(hash, component);
+    length++;
+
+    if (!isPrefixMatched && length <= m_maxPrefixLength && (m_prefixLengths & (1ULL << length)) != 0) {
+      auto candidates = m_prefixes.equal_range(hash);
+      for (auto candidate = candidates.first; candidate != candidates.second; ++candidate) {
+        if (candidate->second.size() == length &&
+            candidate->second.compare(0, length, name, 0, length) == 0) {
+          isPrefixMatched = true;
+          break;
+        }
+      }
+    }
+
+    if (!isPrefixMatched && length >= m_maxPrefixLength) {
+      return false;
+    }
+    if (isPrefixMatched && m_sampling <= 1) {
+      return true;
+    }
+  }
+
+  return isPrefixMatched && (m_sampling <= 1 || mix(hash) % m_sampling == 0);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef TRACE_FILTER_H
+#define TRACE_FILTER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ns3/node.h"
+#include "ns3/node-container.h"
+
+#include <map>
+#include <set>
+#include <unordered_map>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Selects the packets a tracer records
+ *
+ * A filter is compiled once from a rule string of semicolon separated clauses, e.g.
+ *
+ *     prefix=/voip,/video;type=InData,OutData;node=core;sample=100
+ *
+ * - prefix: names below one of the prefixes (component-wise match)
+ * - type: InInterest, OutInterest, InData, OutData, InNack, OutNack
+ * - node: node names, node ids or the name of a node set passed to compile()
+ * - sample: trace 1 in N names. The decision is a function of the name, so a sampled
+ *   packet is traced on every hop of its path.
+ *
+ * Values of a clause are alternatives, clauses must all match. Omitted clauses match
+ * everything. Nodes are filtered when the tracers are installed, the other rules are
+ * evaluated on a hash computed in a single pass over the name components.
+ */
+class TraceFilter
+{
+public:
+  enum PacketType : uint8_t {
+    IN_INTEREST = 0,
+    OUT_INTEREST = 1,
+    IN_DATA = 2,
+    OUT_DATA = 3,
+    IN_NACK = 4,
+    OUT_NACK = 5
+  };
+
+  /**
+   * @brief Compiles @p rules, aborts the simulation if they cannot be parsed
+   *
+   * @param rules rule string, an empty string accepts every packet
+   * @param nodeSets named sets of nodes that can be used in the node clause
+   */
+  static shared_ptr<TraceFilter>
+  compile(const std::string& rules,
+          const std::map<std::string, NodeContainer>& nodeSets = std::map<std::string, NodeContainer>());
+
+  /**
+   * @brief Whether packets of @p node are traced at all
+   */
+  bool
+  acceptsNode(Ptr<Node> node) const
+  {
+    return m_nodes.empty() || m_nodes.count(node->GetId()) > 0;
+  }
+
+  /**
+   * @brief Whether a packet of @p type with @p name is traced
+   */
+  bool
+  accepts(PacketType type, const Name& name) const
+  {
+    if ((m_typeMask & (1 << type)) == 0) {
+      return false;
+    }
+    if (m_prefixes.empty() && m_sampling <= 1) {
+      return true;
+    }
+    return acceptsName(name);
+  }
+
+  /**
+   * @brief Whether the filter may reject packets of a traced node
+   */
+  bool
+  isFiltering() const
+  {
+    return m_typeMask != ALL_TYPES || !m_prefixes.empty() || m_sampling > 1;
+  }
+
+private:
+  bool
+  acceptsName(const Name& name) const;
+
+private:
+  static const uint8_t ALL_TYPES = 0x3f;
+
+  uint8_t m_typeMask = ALL_TYPES;
+  std::set<uint32_t> m_nodes;
+  uint64_t m_sampling = 1;
+
+  /// prefixes by hash of their components, the names are only compared on a hash match
+  std::unordered_multimap<uint64_t, Name> m_prefixes;
+  /// bit i is set if a prefix of i components exists
+  uint64_t m_prefixLengths = 0;
+  size_t m_maxPrefixLength = 0;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // TRACE_FILTER_H
@@ -0,0 +1,333 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "trace-sink.hpp"
+
+#include "ns3/log.h"
+
+#include <cstring>
+#include <streambuf>
+
+NS_LOG_COMPONENT_DEFINE("ndn.TraceSink");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+/**
+ * @brief Collects output in a batch and hands the complete lines of it to a sink
+ */
+class LineBatchStreambuf : public std::streambuf
+{
+public:
+  explicit
+  LineBatchStreambuf(TraceSink& sink)
+    : m_sink(sink)
+    , m_buffer(TraceSink::BATCH_SIZE)
+  {
+    setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+  }
+
+  ~LineBatchStreambuf()
+  {
+    if (pptr() > pbase()) {
+      m_sink.write(pbase(), pptr() - pbase());
+    }
+  }
+
+protected:
+  int_type
+  overflow(int_type c) override
+  {
+    handOver();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(c);
+      pbump(1);
+    }
+    return traits_type::not_eof(c);
+  }
+
+private:
+  void
+  handOver()
+  {
+    char* end = pptr();
+    while (end > pbase() && *(end - 1) != '\n') {
+      --end;
+    }
+    // a single line longer than the batch is cut
+    if (end == pbase()) {
+      end = pptr();
+    }
+
+    m_sink.write(pbase(), end - pbase());
+
+    size_t remaining = pptr() - end;
+    std::memmove(m_buffer.data(), end, remaining);
+    setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+    pbump(static_cast<int>(remaining));
+  }
+
+private:
+  TraceSink& m_sink;
+  std::vector<char> m_buffer;
+};
+
+class SinkStream : public std::ostream
+{
+public:
+  explicit
+  SinkStream(shared_ptr<TraceSink> sink)
+    : std::ostream(nullptr)
+    , m_sink(sink)
+    , m_streambuf(*sink)
+  {
+    rdbuf(&m_streambuf);
+  }
+
+private:
+  // destroyed after the streambuf, which writes its last batch on destruction
+  shared_ptr<TraceSink> m_sink;
+  LineBatchStreambuf m_streambuf;
+};
+
+} // namespace
+
+shared_ptr<TraceSink>
+TraceSink::open(const std::string& file, Mode mode)
+{
+  if (file == "-") {
+    return make_shared<FileTraceSink>(stdout);
+  }
+
+  FILE* handle = std::fopen(file.c_str(), "w");
+  if (handle == nullptr) {
+    NS_LOG_ERROR("File " << file << " cannot be opened for writing");
+    return nullptr;
+  }
+
+  if (mode == SYNCHRONOUS) {
+    return make_shared<FileTraceSink>(handle);
+  }
+  return make_shared<AsyncTraceSink>(handle, mode == ASYNC_DROP);
+}
+
+TraceSink::~TraceSink()
+{
+}
+
+shared_ptr<std::ostream>
+TraceSink::getStream()
+{
+  return make_shared<SinkStream>(shared_from_this());
+}
+
+FileTraceSink::FileTraceSink(FILE* file)
+  : m_file(file)
+{
+}
+
+FileTraceSink::~FileTraceSink()
+{
+  if (m_file != stdout) {
+    std::fclose(m_file);
+  }
+  else {
+    std::fflush(m_file);
+  }
+}
+
+void
+FileTraceSink::write(const char* data, size_t size)
+{
+  m_stats.nBatches++;
+  m_stats.nBytes += size;
+  if (std::fwrite(data, 1, size, m_file) != size) {
+    NS_LOG_ERROR("Writing trace batch failed");
+  }
+}
+
+void
+FileTraceSink::flush()
+{
+  std::fflush(m_file);
+}
+
+AsyncTraceSink::Ring::Ring(size_t capacity)
+  : m_slots(capacity + 1)
+  , m_head(0)
+  , m_tail(0)
+{
+}
+
+bool
+AsyncTraceSink::Ring::push(Batch* batch)
+{
+  size_t tail = m_tail.load(std::memory_order_relaxed);
+  size_t next = (tail + 1) % m_slots.size();
+  if (next == m_head.load(std::memory_order_acquire)) {
+    return false;
+  }
+  m_slots[tail] = batch;
+  m_tail.store(next, std::memory_order_release);
+  return true;
+}
+
+AsyncTraceSink::Batch*
+AsyncTraceSink::Ring::pop()
+{
+  size_t head = m_head.load(std::memory_order_relaxed);
+  if (head == m_tail.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  Batch* batch = m_slots[head];
+  m_head.store((head + 1) % m_slots.size(), std::memory_order_release);
+  return batch;
+}
+
+bool
+AsyncTraceSink::Ring::isEmpty() const
+{
+  return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_acquire);
+}
+
+AsyncTraceSink::AsyncTraceSink(FILE* file, bool dropIfFull)
+  : m_file(file)
+  , m_dropIfFull(dropIfFull)
+  , m_batches(QUEUE_LENGTH)
+  , m_queued(QUEUE_LENGTH)
+  , m_free(QUEUE_LENGTH)
+  , m_nSubmitted(0)
+  , m_nWritten(0)
+  , m_isClosing(false)
+  , m_isWriterWaiting(false)
+  , m_isSimulatorWaiting(false)
+{
+  // batches are written in one piece, stdio buffering would only copy them again
+  std::setvbuf(m_file, nullptr, _IONBF, 0);
+
+  for (Batch& batch : m_batches) {
+    batch.data.resize(BATCH_SIZE);
+    m_free.push(&batch);
+  }
+
+  m_thread = std::thread(&AsyncTraceSink::run, this);
+}
+
+AsyncTraceSink::~AsyncTraceSink()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isClosing = true;
+    m_writerWakeup.notify_one();
+  }
+  m_thread.join();
+  std::fclose(m_file);
+}
+
+void
+AsyncTraceSink::write(const char* data, size_t size)
+{
+  BOOST_ASSERT(size <= BATCH_SIZE);
+
+  Batch* batch = m_free.pop();
+  if (batch == nullptr) {
+    if (m_dropIfFull) {
+      m_stats.nDroppedBatches++;
+      m_stats.nDroppedBytes += size;
+      return;
+    }
+
+    m_stats.nStalls++;
+    waitForWriter([this, &batch] { return (batch = m_free.pop()) != nullptr; });
+  }
+
+  std::memcpy(batch->data.data(), data, size);
+  batch->size = size;
+  m_stats.nBatches++;
+  m_stats.nBytes += size;
+
+  m_nSubmitted.fetch_add(1, std::memory_order_relaxed);
+  // cannot fail, there are as many slots as batches
+  m_queued.push(batch);
+  wake(m_isWriterWaiting, m_writerWakeup);
+}
+
+void
+AsyncTraceSink::flush()
+{
+  waitForWriter([this] {
+    return m_nWritten.load(std::memory_order_acquire) >= m_nSubmitted.load(std::memory_order_relaxed);
+  });
+}
+
+template<typename Predicate>
+void
+AsyncTraceSink::waitForWriter(Predicate isDone)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_isSimulatorWaiting.store(true);
+  // orders the flag before the first evaluation of isDone, see wake()
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  m_simulatorWakeup.wait(lock, isDone);
+  m_isSimulatorWaiting.store(false);
+}
+
+void
+AsyncTraceSink::wake(const std::atomic<bool>& isWaiting, std::condition_variable& wakeup)
+{
+  // either the waiting thread sees the published state when it checks its condition, or
+  // this thread sees its flag; the lock then makes sure it is already inside wait()
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (isWaiting.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    wakeup.notify_one();
+  }
+}
+
+void
+AsyncTraceSink::run()
+{
+  while (true) {
+    Batch* batch = m_queued.pop();
+    if (batch == nullptr) {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_isWriterWaiting.store(true);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      m_writerWakeup.wait(lock, [this] { return !m_queued.isEmpty() || m_isClosing.load(); });
+      m_isWriterWaiting.store(false);
+      // when closing, the queue is drained first, so no batch queued before is lost
+      if (m_queued.isEmpty()) {
+        return;
+      }
+      continue;
+    }
+
+    if (std::fwrite(batch->data.data(), 1, batch->size, m_file) != batch->size) {
+      NS_LOG_ERROR("Writing trace batch failed");
+    }
+    m_free.push(batch);
+    m_nWritten.fetch_add(1, std::memory_order_release);
+    wake(m_isSimulatorWaiting, m_simulatorWakeup);
+  }
+}
+
+} // namespace ndn
+} // namespace ns3
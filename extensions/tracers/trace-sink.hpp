@@ -0,0 +1,239 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef TRACE_SINK_H
+#define TRACE_SINK_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Destination of text traces
+ *
+ * Tracers write to the std::ostream returned by getStream(). The stream collects complete
+ * lines in batches of at most BATCH_SIZE bytes and hands them to write(), so a sink never
+ * sees a partial record. std::endl does not cut a batch short, the remainder is handed over
+ * when the last stream of the sink is destroyed.
+ */
+class TraceSink : public std::enable_shared_from_this<TraceSink>
+{
+public:
+  struct Stats
+  {
+    uint64_t nBatches = 0;
+    uint64_t nBytes = 0;
+    uint64_t nDroppedBatches = 0; ///< batches discarded because the writer fell behind
+    uint64_t nDroppedBytes = 0;
+    uint64_t nStalls = 0;         ///< batches the simulation had to wait for
+  };
+
+  enum Mode {
+    SYNCHRONOUS, ///< write on the simulator thread
+    ASYNC_BLOCK, ///< background thread, wait if its queue is full
+    ASYNC_DROP   ///< background thread, drop batches if its queue is full
+  };
+
+  static const size_t BATCH_SIZE = 64 * 1024;
+
+  /**
+   * @brief Opens @p file for writing, "-" writes to std::cout synchronously
+   * @return nullptr if the file cannot be opened
+   */
+  static shared_ptr<TraceSink>
+  open(const std::string& file, Mode mode = SYNCHRONOUS);
+
+  virtual
+  ~TraceSink();
+
+  /**
+   * @brief Returns a stream writing complete lines to this sink
+   *
+   * The stream keeps the sink alive.
+   */
+  shared_ptr<std::ostream>
+  getStream();
+
+  /**
+   * @brief Writes @p size bytes of complete records, @p size is at most BATCH_SIZE
+   */
+  virtual void
+  write(const char* data, size_t size) = 0;
+
+  /**
+   * @brief Waits until all batches handed to write() are on disk
+   */
+  virtual void
+  flush() = 0;
+
+  const Stats&
+  getStats() const
+  {
+    return m_stats;
+  }
+
+protected:
+  Stats m_stats;
+};
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Trace sink writing on the simulator thread
+ */
+class FileTraceSink : public TraceSink
+{
+public:
+  /**
+   * @param file owned file handle, closed by the destructor unless it is stdout
+   */
+  explicit
+  FileTraceSink(FILE* file);
+
+  ~FileTraceSink();
+
+  void
+  write(const char* data, size_t size) override;
+
+  void
+  flush() override;
+
+private:
+  FILE* m_file;
+};
+
+/**
+ * @ingroup ndn-tracers
+ * @brief Trace sink writing from a background thread
+ *
+ * Batches are copied into one of QUEUE_LENGTH preallocated buffers and passed to the
+ * writer thread through a lock-free single-producer single-consumer ring; the buffers
+ * return through a second ring. Neither thread takes a lock while the other one is busy: a
+ * thread that runs out of work parks on a condition variable, and the other thread only
+ * locks to wake it. If no buffer is free, the simulator either waits for the writer or
+ * drops the batch, depending on the mode.
+ */
+class AsyncTraceSink : public TraceSink
+{
+public:
+  static const size_t QUEUE_LENGTH = 64;
+
+  /**
+   * @param file owned file handle, closed by the destructor
+   * @param dropIfFull drop batches instead of waiting if all buffers are queued
+   */
+  AsyncTraceSink(FILE* file, bool dropIfFull);
+
+  /**
+   * @brief Writes the queued batches and stops the writer thread
+   */
+  ~AsyncTraceSink();
+
+  void
+  write(const char* data, size_t size) override;
+
+  void
+  flush() override;
+
+private:
+  struct Batch
+  {
+    std::vector<char> data;
+    size_t size = 0;
+  };
+
+  /** @brief Bounded lock-free queue for exactly one producer and one consumer thread
+   */
+  class Ring
+  {
+  public:
+    explicit
+    Ring(size_t capacity);
+
+    bool
+    push(Batch* batch);
+
+    Batch*
+    pop();
+
+    /** @brief Whether the queue is empty, only valid in the consumer thread
+     */
+    bool
+    isEmpty() const;
+
+  private:
+    std::vector<Batch*> m_slots;
+    // producer and consumer index on separate cache lines
+    alignas(64) std::atomic<size_t> m_head;
+    alignas(64) std::atomic<size_t> m_tail;
+  };
+
+  void
+  run();
+
+  /** @brief Blocks the simulator thread until @p isDone returns true
+   *
+   *  @p isDone is evaluated under m_mutex, each time the writer has written a batch.
+   */
+  template<typename Predicate>
+  void
+  waitForWriter(Predicate isDone);
+
+  /** @brief Wakes the thread waiting on @p wakeup, if @p isWaiting is set
+   *
+   *  To be called after the state that thread waits for has been published.
+   */
+  void
+  wake(const std::atomic<bool>& isWaiting, std::condition_variable& wakeup);
+
+private:
+  FILE* m_file;
+  bool m_dropIfFull;
+
+  std::vector<Batch> m_batches;
+  Ring m_queued; ///< simulator -> writer
+  Ring m_free;   ///< writer -> simulator
+
+  std::atomic<uint64_t> m_nSubmitted;
+  std::atomic<uint64_t> m_nWritten;
+  std::atomic<bool> m_isClosing;
+
+  // parking of the writer on an empty queue and of the simulator on a full one or in flush()
+  std::mutex m_mutex;
+  std::condition_variable m_writerWakeup;
+  std::condition_variable m_simulatorWakeup;
+  std::atomic<bool> m_isWriterWaiting;
+  std::atomic<bool> m_isSimulatorWaiting;
+
+  std::thread m_thread;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // TRACE_SINK_H
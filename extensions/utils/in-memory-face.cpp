@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "in-memory-face.hpp"
+
+#include "fw/forwarder.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+InMemoryTransport::InMemoryTransport(const std::string& remoteUri)
+{
+  setLocalUri(nfd::FaceUri("inmemory://forwarder"));
+  setRemoteUri(nfd::FaceUri(remoteUri));
+  setScope(::ndn::nfd::FACE_SCOPE_NON_LOCAL);
+  setPersistency(::ndn::nfd::FACE_PERSISTENCY_PERMANENT);
+  setLinkType(::ndn::nfd::LINK_TYPE_POINT_TO_POINT);
+  setMtu(nfd::face::MTU_UNLIMITED);
+}
+
+void
+InMemoryTransport::beforeChangePersistency(::ndn::nfd::FacePersistency newPersistency)
+{
+}
+
+void
+InMemoryTransport::doClose()
+{
+  setState(nfd::face::TransportState::CLOSED);
+}
+
+void
+InMemoryTransport::doSend(Packet&& packet)
+{
+}
+
+shared_ptr<Interest>
+InMemoryLinkService::takeSentInterest(const Name& name)
+{
+  auto entry = m_sentInterests.find(name);
+  if (entry == m_sentInterests.end()) {
+    return nullptr;
+  }
+  shared_ptr<Interest> interest = entry->second;
+  m_sentInterests.erase(entry);
+  return interest;
+}
+
+InMemoryLinkService*
+InMemoryLinkService::AddFace(nfd::Forwarder& forwarder, const std::string& remoteUri)
+{
+  InMemoryLinkService* linkService = new InMemoryLinkService();
+  auto face = make_shared<nfd::Face>(std::unique_ptr<nfd::face::LinkService>(linkService),
+                                     std::unique_ptr<nfd::face::Transport>(
+                                       new InMemoryTransport(remoteUri)));
+  linkService->m_forwarderFace = face.get();
+  forwarder.getFaceTable().add(face);
+  return linkService;
+}
+
+void
+InMemoryLinkService::doSendInterest(const Interest& interest)
+{
+  ++nSentInterests;
+  if (m_keepsSentInterests) {
+    m_sentInterests[interest.getName()] = make_shared<Interest>(interest);
+  }
+}
+
+void
+InMemoryLinkService::doSendData(const Data& data)
+{
+  ++nSentData;
+}
+
+void
+InMemoryLinkService::doSendNack(const lp::Nack& nack)
+{
+  ++nSentNacks;
+}
+
+void
+InMemoryLinkService::doReceivePacket(nfd::face::Transport::Packet&& packet)
+{
+}
+
+} // namespace ndn
+} // namespace ns3
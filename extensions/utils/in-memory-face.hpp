@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef IN_MEMORY_FACE_H
+#define IN_MEMORY_FACE_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "face/face.hpp"
+#include "face/link-service.hpp"
+#include "face/transport.hpp"
+
+#include <map>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Transport of an InMemoryLinkService, discards everything sent on it
+ */
+class InMemoryTransport : public nfd::face::Transport
+{
+public:
+  /**
+   * @param remoteUri remote URI of the face, e.g. "benchmark://upstream0"
+   */
+  explicit
+  InMemoryTransport(const std::string& remoteUri);
+
+private:
+  virtual void
+  beforeChangePersistency(::ndn::nfd::FacePersistency newPersistency);
+
+  virtual void
+  doClose();
+
+  virtual void
+  doSend(Packet&& packet);
+};
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Face of a forwarder that is not connected to a node or a NetDevice
+ *
+ * Benchmarks and the trace replay inject packets into the forwarder with inject*() as if
+ * they arrived on the face. Packets sent by the forwarder are only counted, no packet is
+ * ever encoded. The Interests sent last for each name can be kept, so that a Nack for
+ * them carries the nonce the forwarder expects.
+ */
+class InMemoryLinkService : public nfd::face::LinkService
+{
+public:
+  void
+  injectInterest(const Interest& interest)
+  {
+    receiveInterest(interest);
+  }
+
+  void
+  injectData(const Data& data)
+  {
+    receiveData(data);
+  }
+
+  void
+  injectNack(const lp::Nack& nack)
+  {
+    receiveNack(nack);
+  }
+
+  /**
+   * @brief Keeps the last Interest sent for each name, see takeSentInterest()
+   */
+  void
+  keepSentInterests()
+  {
+    m_keepsSentInterests = true;
+  }
+
+  /**
+   * @brief Returns and forgets the last Interest sent for @p name, nullptr if there is none
+   */
+  shared_ptr<Interest>
+  takeSentInterest(const Name& name);
+
+  /**
+   * @brief Creates a face with an InMemoryLinkService and adds it to @p forwarder
+   */
+  static InMemoryLinkService*
+  AddFace(nfd::Forwarder& forwarder, const std::string& remoteUri);
+
+  /**
+   * @brief Face created by AddFace(), e.g. to add it as next hop to the FIB
+   */
+  nfd::Face&
+  getForwarderFace() const
+  {
+    return *m_forwarderFace;
+  }
+
+public:
+  uint64_t nSentInterests = 0;
+  uint64_t nSentData = 0;
+  uint64_t nSentNacks = 0;
+
+private:
+  virtual void
+  doSendInterest(const Interest& interest);
+
+  virtual void
+  doSendData(const Data& data);
+
+  virtual void
+  doSendNack(const lp::Nack& nack);
+
+  virtual void
+  doReceivePacket(nfd::face::Transport::Packet&& packet);
+
+private:
+  nfd::Face* m_forwarderFace = nullptr;
+  bool m_keepsSentInterests = false;
+  std::map<Name, shared_ptr<Interest>> m_sentInterests;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // IN_MEMORY_FACE_H
@@ -0,0 +1,327 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "link-failure-engine.hpp"
+
+#include "ns3/log.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.LinkFailureEngine");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+typedef std::map<std::string, std::string> Parameters;
+
+double
+GetNumber(const Parameters& parameters, const std::string& key, double defaultValue)
+{
+  auto it = parameters.find(key);
+  if (it == parameters.end()) {
+    return defaultValue;
+  }
+  try {
+    return std::stod(it->second);
+  }
+  catch (const std::exception&) {
+    NS_FATAL_ERROR("Link failure schedule: " << key << "=" << it->second << " is not a number");
+  }
+}
+
+double
+GetNumber(const Parameters& parameters, const std::string& key)
+{
+  if (parameters.count(key) == 0) {
+    NS_FATAL_ERROR("Link failure schedule: missing " << key << "=");
+  }
+  return GetNumber(parameters, key, 0);
+}
+
+LinkFailureEngine::NodePair
+ParseLink(const std::string& link)
+{
+  size_t dash = link.find('-');
+  try {
+    if (dash != std::string::npos) {
+      return {static_cast<uint32_t>(std::stoul(link.substr(0, dash))),
+              static_cast<uint32_t>(std::stoul(link.substr(dash + 1)))};
+    }
+  }
+  catch (const std::exception&) {
+  }
+  NS_FATAL_ERROR("Link failure schedule: link '" << link << "' is not of the form node1-node2");
+}
+
+std::vector<LinkFailureEngine::NodePair>
+ParseLinks(const std::string& links)
+{
+  std::vector<LinkFailureEngine::NodePair> result;
+  std::stringstream ss(links);
+  std::string link;
+  while (std::getline(ss, link, ',')) {
+    result.push_back(ParseLink(link));
+  }
+  return result;
+}
+
+/// exponentially distributed value with the given mean
+double
+Exponential(Ptr<UniformRandomVariable> random, double mean)
+{
+  return -mean * std::log(1.0 - random->GetValue(0.0, 1.0));
+}
+
+} // namespace
+
+void
+LinkFailureEngine::schedule(Ptr<Node> node1, Ptr<Node> node2, Time start, Time stop,
+                            double errorRate)
+{
+  size_t link = resolve(node1, node2);
+  Simulator::Schedule(start, &LinkFailureEngine::fail, this, link, errorRate);
+  Simulator::Schedule(stop, &LinkFailureEngine::restore, this, link);
+}
+
+size_t
+LinkFailureEngine::resolve(Ptr<Node> node1, Ptr<Node> node2)
+{
+  uint32_t id1 = std::min(node1->GetId(), node2->GetId());
+  uint32_t id2 = std::max(node1->GetId(), node2->GetId());
+  uint64_t key = (static_cast<uint64_t>(id1) << 32) | id2;
+
+  auto it = m_linkIndex.find(key);
+  if (it != m_linkIndex.end()) {
+    return it->second;
+  }
+
+  for (uint32_t i = 0; i < node1->GetNDevices(); i++) {
+    Ptr<PointToPointNetDevice> device1 = DynamicCast<PointToPointNetDevice>(node1->GetDevice(i));
+    if (device1 == nullptr) {
+      continue;
+    }
+    Ptr<PointToPointChannel> channel = DynamicCast<PointToPointChannel>(device1->GetChannel());
+    if (channel == nullptr) {
+      continue;
+    }
+
+    Ptr<NetDevice> device2 = channel->GetDevice(0);
+    if (device2 == device1) {
+      device2 = channel->GetDevice(1);
+    }
+    if (device2->GetNode() == node2) {
+      Link link;
+      link.device1 = device1;
+      link.device2 = DynamicCast<PointToPointNetDevice>(device2);
+      m_links.push_back(link);
+      m_linkIndex[key] = m_links.size() - 1;
+      return m_links.size() - 1;
+    }
+  }
+  NS_FATAL_ERROR("There is no link to fail between node " << node1->GetId() << " and node "
+                                                          << node2->GetId());
+}
+
+void
+LinkFailureEngine::fail(size_t index, double errorRate)
+{
+  Link& link = m_links[index];
+  NS_LOG_DEBUG("Fail link " << link.device1->GetNode()->GetId() << " - "
+                            << link.device2->GetNode()->GetId() << " with error rate " << errorRate);
+
+  // created on the first failure only, like the models of LinkControlHelper
+  if (link.errorModel1 == nullptr) {
+    link.errorModel1 = CreateObject<RateErrorModel>();
+    link.errorModel1->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+    link.errorModel2 = CreateObject<RateErrorModel>();
+    link.errorModel2->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+  }
+
+  link.errorModel1->SetRate(errorRate);
+  link.errorModel2->SetRate(errorRate);
+
+  if (link.nActiveFailures++ == 0) {
+    // keep the error models of the link itself, e.g. of NetworkGenerator::introduceError
+    PointerValue previous;
+    link.device1->GetAttribute("ReceiveErrorModel", previous);
+    link.previousModel1 = previous.Get<ErrorModel>();
+    link.device2->GetAttribute("ReceiveErrorModel", previous);
+    link.previousModel2 = previous.Get<ErrorModel>();
+
+    link.errorModel1->Enable();
+    link.errorModel2->Enable();
+    link.device1->SetReceiveErrorModel(link.errorModel1);
+    link.device2->SetReceiveErrorModel(link.errorModel2);
+  }
+}
+
+void
+LinkFailureEngine::restore(size_t index)
+{
+  Link& link = m_links[index];
+  if (link.nActiveFailures == 0 || --link.nActiveFailures > 0) {
+    return;
+  }
+  NS_LOG_DEBUG("Restore link " << link.device1->GetNode()->GetId() << " - "
+                               << link.device2->GetNode()->GetId());
+
+  link.errorModel1->Disable();
+  link.errorModel2->Disable();
+  link.device1->SetReceiveErrorModel(link.previousModel1);
+  link.device2->SetReceiveErrorModel(link.previousModel2);
+  link.previousModel1 = nullptr;
+  link.previousModel2 = nullptr;
+}
+
+std::vector<LinkFailureEngine::Failure>
+LinkFailureEngine::ReadSchedule(const std::string& file,
+                                const std::map<std::string, std::vector<NodePair>>& linkSets,
+                                Ptr<UniformRandomVariable> random)
+{
+  std::ifstream is(file);
+  if (!is) {
+    NS_FATAL_ERROR("Cannot open link failure schedule " << file);
+  }
+
+  std::vector<Failure> failures;
+  std::string line;
+  while (std::getline(is, line)) {
+    line = line.substr(0, line.find('#'));
+    std::stringstream ss(line);
+    std::string process;
+    if (!(ss >> process)) {
+      continue;
+    }
+
+    Parameters parameters;
+    std::string token;
+    while (ss >> token) {
+      size_t eq = token.find('=');
+      if (eq == std::string::npos) {
+        NS_FATAL_ERROR("Link failure schedule: '" << token << "' is not of the form key=value");
+      }
+      parameters[token.substr(0, eq)] = token.substr(eq + 1);
+    }
+
+    double errorRate = GetNumber(parameters, "errorRate", 1.0);
+    double start = GetNumber(parameters, "start", 0.0);
+    double stop = GetNumber(parameters, "stop", std::numeric_limits<double>::infinity());
+
+    auto addFailure = [&] (const std::vector<NodePair>& links, double time, double duration) {
+      for (const NodePair& link : links) {
+        failures.push_back({link.first, link.second, time, time + duration, errorRate});
+      }
+    };
+
+    // failure times of a Poisson process, calls addLinks(time, duration) for every failure
+    auto poisson = [&] (const std::function<void(double, double)>& addLinks) {
+      double rate = GetNumber(parameters, "rate");
+      double duration = GetNumber(parameters, "duration");
+      if (rate <= 0) {
+        return;
+      }
+      if (std::isinf(stop)) {
+        NS_FATAL_ERROR("Link failure schedule: " << process << " needs stop=");
+      }
+      for (double time = start + Exponential(random, 1000.0 / rate); time < stop;
+           time += Exponential(random, 1000.0 / rate)) {
+        addLinks(time, Exponential(random, duration));
+      }
+    };
+
+    auto getLinkSet = [&] () -> const std::vector<NodePair>& {
+      std::string name = parameters.count("links") > 0 ? parameters["links"] : "all";
+      auto it = linkSets.find(name);
+      if (it == linkSets.end()) {
+        NS_FATAL_ERROR("Link failure schedule: unknown link set " << name);
+      }
+      if (it->second.empty()) {
+        NS_FATAL_ERROR("Link failure schedule: link set " << name << " is empty");
+      }
+      return it->second;
+    };
+
+    if (process == "poisson") {
+      const std::vector<NodePair>& links = getLinkSet();
+      poisson([&] (double time, double duration) {
+        addFailure({links[random->GetInteger(0, links.size() - 1)]}, time, duration);
+      });
+    }
+    else if (process == "correlated") {
+      const std::vector<NodePair>& links = getLinkSet();
+      uint32_t nNeighbors = GetNumber(parameters, "neighbors");
+      poisson([&] (double time, double duration) {
+        NodePair failed = links[random->GetInteger(0, links.size() - 1)];
+        std::vector<NodePair> neighbors;
+        for (const NodePair& link : links) {
+          if (link != failed && (link.first == failed.first || link.first == failed.second ||
+                                 link.second == failed.first || link.second == failed.second)) {
+            neighbors.push_back(link);
+          }
+        }
+        // partial Fisher-Yates shuffle, the first nNeighbors fail with the drawn link
+        size_t n = std::min<size_t>(nNeighbors, neighbors.size());
+        for (size_t i = 0; i < n; i++) {
+          std::swap(neighbors[i], neighbors[random->GetInteger(i, neighbors.size() - 1)]);
+        }
+        neighbors.resize(n);
+        neighbors.insert(neighbors.begin(), failed);
+        addFailure(neighbors, time, duration);
+      });
+    }
+    else if (process == "srlg") {
+      if (parameters.count("group") == 0) {
+        NS_FATAL_ERROR("Link failure schedule: missing group=");
+      }
+      std::vector<NodePair> group = ParseLinks(parameters["group"]);
+      if (parameters.count("at") > 0) {
+        addFailure(group, GetNumber(parameters, "at"), GetNumber(parameters, "duration"));
+      }
+      else {
+        poisson([&] (double time, double duration) { addFailure(group, time, duration); });
+      }
+    }
+    else if (process == "fail") {
+      if (parameters.count("link") == 0) {
+        NS_FATAL_ERROR("Link failure schedule: missing link=");
+      }
+      addFailure({ParseLink(parameters["link"])}, GetNumber(parameters, "at"),
+                 GetNumber(parameters, "duration"));
+    }
+    else {
+      NS_FATAL_ERROR("Link failure schedule: unknown failure process " << process);
+    }
+  }
+
+  NS_LOG_INFO(failures.size() << " link failures from " << file);
+  return failures;
+}
+
+} // namespace ndn
+} // namespace ns3
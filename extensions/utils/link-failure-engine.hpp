@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef LINK_FAILURE_ENGINE_H
+#define LINK_FAILURE_ENGINE_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/error-model.h"
+#include "ns3/node.h"
+#include "ns3/nstime.h"
+#include "ns3/point-to-point-net-device.h"
+#include "ns3/random-variable-stream.h"
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Fails and restores point-to-point links with receive error models
+ *
+ * Does the same as LinkControlHelper::FailLink and UpLink, which look up the link
+ * among the faces of the first node and create two new RateErrorModels on every call.
+ * Here the devices of a node pair are looked up once when the first failure of the link
+ * is scheduled. Its two error models are created on the first failure and only enabled
+ * and disabled afterwards, so a failure costs two events without allocations. Overlapping
+ * failures of a link are counted, the link comes up when the last of them ends. The error
+ * models the devices had before the failure are restored then.
+ *
+ * ReadSchedule() generates failures from a schedule file with one failure process per
+ * line, times and durations in milliseconds:
+ *
+ *     # random links of a set fail as a Poisson process (rate: failures per second),
+ *     # durations are exponentially distributed with the given mean
+ *     poisson    rate=0.01 duration=150000 links=core start=0 stop=600000 errorRate=1
+ *     # like poisson, up to <neighbors> links sharing a node with the failed link fail with it
+ *     correlated rate=0.005 duration=60000 neighbors=2 links=all stop=600000
+ *     # shared risk link group, its links always fail together, as a Poisson process or once
+ *     srlg       group=3-7,3-9,12-40 rate=0.001 duration=30000 stop=600000
+ *     srlg       group=3-7,3-9 at=120000 duration=5000
+ *     # a single failure
+ *     fail       link=3-7 at=1000 duration=2000 errorRate=0.5
+ *
+ * Poisson processes need stop, start (default 0), links (default "all") and errorRate
+ * (default 1) are optional. Link sets are passed to ReadSchedule(), links are node id pairs.
+ */
+class LinkFailureEngine
+{
+public:
+  typedef std::pair<uint32_t, uint32_t> NodePair;
+
+  struct Failure
+  {
+    uint32_t node1;
+    uint32_t node2;
+    double startTime; ///< ms
+    double stopTime;  ///< ms
+    double errorRate;
+  };
+
+  /**
+   * @brief Schedules the failure of the link between @p node1 and @p node2
+   *
+   * Aborts if the nodes are not connected by a point-to-point link.
+   */
+  void
+  schedule(Ptr<Node> node1, Ptr<Node> node2, Time start, Time stop, double errorRate);
+
+  /**
+   * @brief Generates the failures of the processes in @p file
+   *
+   * @param linkSets named sets of links that can be used in links=
+   * @param random source of all random decisions, e.g. the generator's variable
+   */
+  static std::vector<Failure>
+  ReadSchedule(const std::string& file, const std::map<std::string, std::vector<NodePair>>& linkSets,
+               Ptr<UniformRandomVariable> random);
+
+private:
+  struct Link
+  {
+    Ptr<PointToPointNetDevice> device1;
+    Ptr<PointToPointNetDevice> device2;
+    Ptr<RateErrorModel> errorModel1;
+    Ptr<RateErrorModel> errorModel2;
+    Ptr<ErrorModel> previousModel1;
+    Ptr<ErrorModel> previousModel2;
+    uint32_t nActiveFailures = 0;
+  };
+
+  size_t
+  resolve(Ptr<Node> node1, Ptr<Node> node2);
+
+  void
+  fail(size_t link, double errorRate);
+
+  void
+  restore(size_t link);
+
+private:
+  std::unordered_map<uint64_t, size_t> m_linkIndex;
+  std::vector<Link> m_links;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // LINK_FAILURE_ENGINE_H
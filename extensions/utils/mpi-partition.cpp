@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "mpi-partition.hpp"
+
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "ns3/point-to-point-channel.h"
+#include "ns3/point-to-point-net-device.h"
+
+#ifdef NS3_MPI
+#include "ns3/mpi-interface.h"
+#endif
+
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE("ndn.MpiPartition");
+
+namespace ns3 {
+namespace ndn {
+
+void
+MpiPartition::Enable(int* argc, char*** argv)
+{
+#ifdef NS3_MPI
+  MpiInterface::Enable(argc, argv);
+  NS_LOG_INFO("Rank " << GetRank() << " of " << GetSize());
+#else
+  NS_FATAL_ERROR("Distributed simulation needs ns-3 with the mpi module");
+#endif
+}
+
+void
+MpiPartition::Disable()
+{
+#ifdef NS3_MPI
+  if (MpiInterface::IsEnabled()) {
+    MpiInterface::Disable();
+  }
+#endif
+}
+
+bool
+MpiPartition::IsEnabled()
+{
+#ifdef NS3_MPI
+  return MpiInterface::IsEnabled();
+#else
+  return false;
+#endif
+}
+
+uint32_t
+MpiPartition::GetRank()
+{
+#ifdef NS3_MPI
+  if (MpiInterface::IsEnabled()) {
+    return MpiInterface::GetSystemId();
+  }
+#endif
+  return 0;
+}
+
+uint32_t
+MpiPartition::GetSize()
+{
+#ifdef NS3_MPI
+  if (MpiInterface::IsEnabled()) {
+    return MpiInterface::GetSize();
+  }
+#endif
+  return 1;
+}
+
+bool
+MpiPartition::IsLocal(Ptr<Node> node)
+{
+  return GetSize() == 1 || node->GetSystemId() == GetRank();
+}
+
+NodeContainer
+MpiPartition::GetLocalNodes(const NodeContainer& nodes)
+{
+  NodeContainer localNodes;
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); ++node) {
+    if (IsLocal(*node)) {
+      localNodes.Add(*node);
+    }
+  }
+  return localNodes;
+}
+
+std::string
+MpiPartition::GetLocalFileName(const std::string& file)
+{
+  if (GetSize() == 1) {
+    return file;
+  }
+
+  std::string suffix = "-rank" + std::to_string(GetRank());
+  size_t dot = file.rfind('.');
+  if (dot == std::string::npos || file.find('/', dot) != std::string::npos) {
+    return file + suffix;
+  }
+  return file.substr(0, dot) + suffix + file.substr(dot);
+}
+
+Time
+MpiPartition::GetLookahead()
+{
+  Time lookahead = Time::Max();
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    for (uint32_t i = 0; i < (*node)->GetNDevices(); i++) {
+      Ptr<PointToPointChannel> channel =
+        DynamicCast<PointToPointChannel>((*node)->GetDevice(i)->GetChannel());
+      if (channel == nullptr || channel->GetNDevices() != 2) {
+        continue;
+      }
+      if (channel->GetDevice(0)->GetNode()->GetSystemId() ==
+          channel->GetDevice(1)->GetNode()->GetSystemId()) {
+        continue;
+      }
+      TimeValue delay;
+      channel->GetAttribute("Delay", delay);
+      lookahead = std::min(lookahead, delay.Get());
+    }
+  }
+  return lookahead;
+}
+
+} // namespace ndn
+} // namespace ns3
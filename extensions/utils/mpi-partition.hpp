@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef MPI_PARTITION_H
+#define MPI_PARTITION_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/node-container.h"
+
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Helpers of the scenarios for distributed simulation with ns-3 MPI
+ *
+ * NetworkGenerator places every AS on one rank (GetSystemNumberForAs of NDNBriteHelper) and
+ * nodes attached to the AS routers on the rank of their router, so only inter-AS links cross
+ * ranks. DistributedSimulatorImpl takes the lookahead from the delay of these links.
+ *
+ * Every rank builds the whole topology and calculates all routes, but only runs the events of
+ * its own nodes. Applications and tracers are therefore only installed on local nodes, and
+ * every rank writes its own trace files.
+ *
+ * Without MPI (not enabled, or ns-3 built without the mpi module) there is a single rank 0
+ * that owns all nodes.
+ */
+class MpiPartition
+{
+public:
+  /**
+   * @brief Initializes MPI, must be called before the topology is created
+   *
+   * The simulator implementation is selected with
+   * --SimulatorImplementationType=ns3::DistributedSimulatorImpl, as done by ./waf --mpi=<n>.
+   */
+  static void
+  Enable(int* argc, char*** argv);
+
+  /**
+   * @brief Finalizes MPI, after Simulator::Destroy
+   */
+  static void
+  Disable();
+
+  static bool
+  IsEnabled();
+
+  static uint32_t
+  GetRank();
+
+  static uint32_t
+  GetSize();
+
+  /**
+   * @brief Whether the events of @p node are run by this rank
+   */
+  static bool
+  IsLocal(Ptr<Node> node);
+
+  static NodeContainer
+  GetLocalNodes(const NodeContainer& nodes);
+
+  /**
+   * @brief Adds the rank to @p file ("trace.txt" -> "trace-rank1.txt") if there are several
+   */
+  static std::string
+  GetLocalFileName(const std::string& file);
+
+  /**
+   * @brief Minimum delay of the point-to-point links between nodes of different ranks
+   *
+   * This is the lookahead of DistributedSimulatorImpl; Time::Max() if no link crosses ranks.
+   */
+  static Time
+  GetLookahead();
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // MPI_PARTITION_H
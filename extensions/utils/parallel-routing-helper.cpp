@@ -0,0 +1,369 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "parallel-routing-helper.hpp"
+
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+#include "ns3/ndnSIM/model/ndn-global-router.hpp"
+
+#include "fw/forwarder.hpp"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+NS_LOG_COMPONENT_DEFINE("ndn.ParallelRoutingHelper");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+typedef std::tuple_element<1, GlobalRouter::Incidency>::type FacePtr;
+
+// GlobalRoutingHelper disables faces by setting this metric
+const uint32_t DISABLED_METRIC = std::numeric_limits<uint16_t>::max();
+
+const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+const char CACHE_MAGIC[8] = {'N', 'D', 'N', 'F', 'I', 'B', '0', '1'};
+
+struct Edge
+{
+  uint32_t to;
+  uint32_t metric;
+};
+
+struct Route
+{
+  uint32_t edge; ///< index of the first hop in the adjacency list of the source
+  uint32_t destination;
+  uint32_t metric;
+};
+
+/**
+ * Copy of the GlobalRouter graph, routers are identified by their index
+ */
+struct Graph
+{
+  std::vector<Ptr<GlobalRouter>> routers;
+  std::vector<std::vector<Edge>> adjacency;
+  std::vector<std::vector<FacePtr>> faces; ///< face of every edge in adjacency
+  uint64_t hash = FNV_OFFSET;
+
+  void
+  addToHash(uint64_t value)
+  {
+    for (int i = 0; i < 8; i++) {
+      hash = (hash ^ ((value >> (8 * i)) & 0xff)) * FNV_PRIME;
+    }
+  }
+
+  void
+  addToHash(const std::string& value)
+  {
+    addToHash(value.size());
+    for (char c : value) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * FNV_PRIME;
+    }
+  }
+};
+
+void
+buildGraph(Graph& graph, bool isAllPossible)
+{
+  std::unordered_map<const GlobalRouter*, uint32_t> indexes;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    Ptr<GlobalRouter> router = (*node)->GetObject<GlobalRouter>();
+    if (router != 0) {
+      indexes[PeekPointer(router)] = graph.routers.size();
+      graph.routers.push_back(router);
+    }
+  }
+
+  graph.adjacency.resize(graph.routers.size());
+  graph.faces.resize(graph.routers.size());
+  graph.addToHash(isAllPossible ? 1 : 0);
+  graph.addToHash(graph.routers.size());
+
+  for (uint32_t i = 0; i < graph.routers.size(); i++) {
+    Ptr<GlobalRouter> router = graph.routers[i];
+    graph.addToHash(router->GetObject<Node>()->GetId());
+
+    for (const GlobalRouter::Incidency& incidency : router->GetIncidencies()) {
+      Ptr<GlobalRouter> other = std::get<2>(incidency);
+      if (other == 0) {
+        continue;
+      }
+      const FacePtr& face = std::get<1>(incidency);
+      Edge edge = {indexes.at(PeekPointer(other)), static_cast<uint32_t>(face->getMetric())};
+      graph.adjacency[i].push_back(edge);
+      graph.faces[i].push_back(face);
+
+      graph.addToHash(edge.to);
+      graph.addToHash(edge.metric);
+      graph.addToHash(face->getId());
+    }
+
+    for (const auto& prefix : router->GetLocalPrefixes()) {
+      graph.addToHash(prefix->toUri());
+    }
+  }
+}
+
+/**
+ * Routes of @p source. For every first hop, the shortest paths from the neighbor to all
+ * destinations are computed without passing the source again, as GlobalRoutingHelper does
+ * by disabling all other faces of the source.
+ */
+void
+calculateRoutesOf(const Graph& graph, uint32_t source, bool isAllPossible,
+                  std::vector<uint64_t>& distances, std::vector<Route>& best, std::vector<Route>& routes)
+{
+  typedef std::pair<uint64_t, uint32_t> QueueEntry;
+  const uint64_t UNREACHABLE = std::numeric_limits<uint64_t>::max();
+  const std::vector<Edge>& edges = graph.adjacency[source];
+
+  best.assign(graph.routers.size(), Route{0, 0, std::numeric_limits<uint32_t>::max()});
+
+  for (uint32_t e = 0; e < edges.size(); e++) {
+    if (edges[e].metric >= DISABLED_METRIC || edges[e].to == source) {
+      continue;
+    }
+
+    std::fill(distances.begin(), distances.end(), UNREACHABLE);
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+    distances[edges[e].to] = edges[e].metric;
+    queue.push({edges[e].metric, edges[e].to});
+
+    while (!queue.empty()) {
+      QueueEntry entry = queue.top();
+      queue.pop();
+      if (entry.first > distances[entry.second]) {
+        continue;
+      }
+      for (const Edge& edge : graph.adjacency[entry.second]) {
+        if (edge.to == source || edge.metric >= DISABLED_METRIC) {
+          continue;
+        }
+        uint64_t distance = entry.first + edge.metric;
+        if (distance < distances[edge.to]) {
+          distances[edge.to] = distance;
+          queue.push({distance, edge.to});
+        }
+      }
+    }
+
+    for (uint32_t destination = 0; destination < distances.size(); destination++) {
+      if (distances[destination] == UNREACHABLE) {
+        continue;
+      }
+      uint32_t metric = static_cast<uint32_t>(
+        std::min<uint64_t>(distances[destination], std::numeric_limits<int32_t>::max()));
+      if (isAllPossible) {
+        routes.push_back({e, destination, metric});
+      }
+      else if (metric < best[destination].metric) {
+        best[destination] = {e, destination, metric};
+      }
+    }
+  }
+
+  if (!isAllPossible) {
+    for (const Route& route : best) {
+      if (route.metric != std::numeric_limits<uint32_t>::max()) {
+        routes.push_back(route);
+      }
+    }
+  }
+}
+
+void
+calculateAllRoutes(const Graph& graph, bool isAllPossible, size_t nThreads,
+                   std::vector<std::vector<Route>>& routes)
+{
+  routes.assign(graph.routers.size(), std::vector<Route>());
+  std::atomic<size_t> nextSource(0);
+
+  auto work = [&] {
+    std::vector<uint64_t> distances(graph.routers.size());
+    std::vector<Route> best;
+    for (size_t source = nextSource++; source < graph.routers.size(); source = nextSource++) {
+      calculateRoutesOf(graph, source, isAllPossible, distances, best, routes[source]);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < nThreads; i++) {
+    threads.push_back(std::thread(work));
+  }
+  work();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+std::string
+getCacheFile(const std::string& cacheDir, uint64_t hash)
+{
+  std::ostringstream os;
+  os << cacheDir << "/routes-" << std::hex << hash << ".fib";
+  return os.str();
+}
+
+bool
+readCache(const std::string& fileName, const Graph& graph, std::vector<std::vector<Route>>& routes)
+{
+  std::ifstream file(fileName.c_str(), std::ios::binary);
+  if (!file) {
+    return false;
+  }
+
+  char magic[sizeof(CACHE_MAGIC)];
+  uint64_t hash = 0;
+  uint32_t nRouters = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+  file.read(reinterpret_cast<char*>(&nRouters), sizeof(nRouters));
+  if (!file || !std::equal(magic, magic + sizeof(magic), CACHE_MAGIC) || hash != graph.hash
+      || nRouters != graph.routers.size()) {
+    return false;
+  }
+
+  routes.assign(nRouters, std::vector<Route>());
+  for (uint32_t source = 0; source < nRouters; source++) {
+    uint32_t nRoutes = 0;
+    file.read(reinterpret_cast<char*>(&nRoutes), sizeof(nRoutes));
+    if (!file) {
+      return false;
+    }
+    routes[source].resize(nRoutes);
+    file.read(reinterpret_cast<char*>(routes[source].data()), nRoutes * sizeof(Route));
+    if (!file) {
+      return false;
+    }
+    for (const Route& route : routes[source]) {
+      if (route.edge >= graph.adjacency[source].size() || route.destination >= nRouters) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void
+writeCache(const std::string& fileName, const Graph& graph, const std::vector<std::vector<Route>>& routes)
+{
+  // parallel runs on the same topology may write the same file, rename is atomic
+  std::ostringstream tmpName;
+  tmpName << fileName << ".tmp." << getpid();
+
+  std::ofstream file(tmpName.str().c_str(), std::ios::binary | std::ios::trunc);
+  uint32_t nRouters = graph.routers.size();
+  file.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  file.write(reinterpret_cast<const char*>(&graph.hash), sizeof(graph.hash));
+  file.write(reinterpret_cast<const char*>(&nRouters), sizeof(nRouters));
+  for (const std::vector<Route>& sourceRoutes : routes) {
+    uint32_t nRoutes = sourceRoutes.size();
+    file.write(reinterpret_cast<const char*>(&nRoutes), sizeof(nRoutes));
+    file.write(reinterpret_cast<const char*>(sourceRoutes.data()), nRoutes * sizeof(Route));
+  }
+  file.close();
+
+  if (!file || std::rename(tmpName.str().c_str(), fileName.c_str()) != 0) {
+    NS_LOG_WARN("Cannot write route cache " << fileName);
+    std::remove(tmpName.str().c_str());
+  }
+}
+
+size_t
+installRoutes(const Graph& graph, const std::vector<std::vector<Route>>& routes)
+{
+  size_t nNextHops = 0;
+  for (uint32_t source = 0; source < graph.routers.size(); source++) {
+    nfd::Fib& fib = graph.routers[source]->GetL3Protocol()->getForwarder()->getFib();
+    for (const Route& route : routes[source]) {
+      const FacePtr& face = graph.faces[source][route.edge];
+      for (const auto& prefix : graph.routers[route.destination]->GetLocalPrefixes()) {
+        fib.insert(*prefix).first->addNextHop(face, route.metric);
+        nNextHops++;
+      }
+    }
+  }
+  return nNextHops;
+}
+
+} // namespace
+
+void
+ParallelRoutingHelper::CalculateRoutes(const std::string& cacheDir, size_t nThreads)
+{
+  calculate(false, cacheDir, nThreads);
+}
+
+void
+ParallelRoutingHelper::CalculateAllPossibleRoutes(const std::string& cacheDir, size_t nThreads)
+{
+  calculate(true, cacheDir, nThreads);
+}
+
+void
+ParallelRoutingHelper::calculate(bool isAllPossible, const std::string& cacheDir, size_t nThreads)
+{
+  auto start = std::chrono::steady_clock::now();
+  if (nThreads == 0) {
+    nThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  Graph graph;
+  buildGraph(graph, isAllPossible);
+
+  std::vector<std::vector<Route>> routes;
+  std::string cacheFile = cacheDir.empty() ? "" : getCacheFile(cacheDir, graph.hash);
+  bool isCached = !cacheFile.empty() && readCache(cacheFile, graph, routes);
+  if (!isCached) {
+    calculateAllRoutes(graph, isAllPossible, nThreads, routes);
+    if (!cacheFile.empty()) {
+      writeCache(cacheFile, graph, routes);
+    }
+  }
+
+  size_t nNextHops = installRoutes(graph, routes);
+
+  NS_LOG_INFO(nNextHops << " next hops for " << graph.routers.size() << " nodes "
+              << (isCached ? "read from " + cacheFile : "calculated with " + std::to_string(nThreads) + " threads")
+              << " in " << std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now() - start).count() << " ms");
+}
+
+} // namespace ndn
+} // namespace ns3
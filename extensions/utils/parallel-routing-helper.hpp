@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PARALLEL_ROUTING_HELPER_H
+#define PARALLEL_ROUTING_HELPER_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Parallel replacement of GlobalRoutingHelper::CalculateRoutes and
+ *        GlobalRoutingHelper::CalculateAllPossibleRoutes
+ *
+ * Uses the GlobalRouter incidencies and origins set up by GlobalRoutingHelper::Install and
+ * AddOrigins, and computes the same routes. The graph is copied into plain arrays first, so
+ * the shortest path computations of the source nodes run on a pool of threads. The FIB
+ * entries are then inserted directly into the FIBs of the forwarders, without going through
+ * the FIB management of every node.
+ *
+ * With a cache directory, the routes are stored in a file named after a hash of the graph
+ * (nodes, faces, metrics and origins) and the routing mode. A later run on the same topology
+ * only reads and installs them.
+ */
+class ParallelRoutingHelper
+{
+public:
+  /**
+   * @brief Installs the route with the lowest metric towards every origin
+   *
+   * @param cacheDir directory of the route cache, empty disables the cache
+   * @param nThreads number of worker threads, 0 uses all cores
+   */
+  static void
+  CalculateRoutes(const std::string& cacheDir = "", size_t nThreads = 0);
+
+  /**
+   * @brief Installs one route per face towards every origin, with the metric of the
+   *        shortest path starting with that face
+   *
+   * @param cacheDir directory of the route cache, empty disables the cache
+   * @param nThreads number of worker threads, 0 uses all cores
+   */
+  static void
+  CalculateAllPossibleRoutes(const std::string& cacheDir = "", size_t nThreads = 0);
+
+private:
+  static void
+  calculate(bool isAllPossible, const std::string& cacheDir, size_t nThreads);
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // PARALLEL_ROUTING_HELPER_H
@@ -27,6 +27,8 @@ ParameterConfiguration::ParameterConfiguration()
   setParameter("REQUIREMENT_MAXLOSS", P_REQUIREMENT_MAXLOSS);
   setParameter("REQUIREMENT_MINBANDWIDTH", P_REQUIREMENT_MINBANDWIDTH);
   setParameter("RTT_TIME_TABLE_MAX_DURATION", P_RTT_TIME_TABLE_MAX_DURATION);
+  setParameter("PI_REFRESH_COALESCING", P_PI_REFRESH_COALESCING);
+  setParameter("PUSH_SKIP_DNL", P_PUSH_SKIP_DNL);
 }
 
 
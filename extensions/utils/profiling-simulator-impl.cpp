@@ -0,0 +1,249 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "profiling-simulator-impl.hpp"
+
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "ns3/string.h"
+#include "ns3/make-event.h"
+#include "ns3/ndnSIM/model/ndn-l3-protocol.hpp"
+
+#include "fw/forwarder.hpp"
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+
+NS_LOG_COMPONENT_DEFINE("ndn.ProfilingSimulatorImpl");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(ProfilingSimulatorImpl);
+
+namespace {
+
+/**
+ * @brief Counts the execution of the wrapped event
+ */
+class CountedEvent : public EventImpl
+{
+public:
+  CountedEvent(EventImpl* event, uint64_t& nEvents)
+    : m_event(event, false)
+    , m_nEvents(nEvents)
+  {
+  }
+
+protected:
+  virtual void
+  Notify()
+  {
+    ++m_nEvents;
+    m_event->Invoke();
+  }
+
+private:
+  Ptr<EventImpl> m_event;
+  uint64_t& m_nEvents;
+};
+
+size_t
+getRss() // KiB
+{
+  std::ifstream statm("/proc/self/statm");
+  size_t size = 0;
+  size_t resident = 0;
+  statm >> size >> resident;
+  return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+size_t
+getPeakRss() // KiB
+{
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+} // namespace
+
+TypeId
+ProfilingSimulatorImpl::GetTypeId()
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::ProfilingSimulatorImpl")
+      .SetGroupName("Ndn")
+      .SetParent<DefaultSimulatorImpl>()
+      .AddConstructor<ProfilingSimulatorImpl>()
+
+      .AddAttribute("Interval", "Simulated time between two samples", TimeValue(Seconds(1.0)),
+                    MakeTimeAccessor(&ProfilingSimulatorImpl::m_interval), MakeTimeChecker())
+      .AddAttribute("File", "File the samples are written to", StringValue("profile.txt"),
+                    MakeStringAccessor(&ProfilingSimulatorImpl::m_fileName),
+                    MakeStringChecker())
+      .AddAttribute("NodeFile", "File the table sizes of every node are written to (empty=off)",
+                    StringValue("profile-nodes.txt"),
+                    MakeStringAccessor(&ProfilingSimulatorImpl::m_nodeFileName),
+                    MakeStringChecker());
+
+  return tid;
+}
+
+ProfilingSimulatorImpl::ProfilingSimulatorImpl()
+{
+}
+
+ProfilingSimulatorImpl::~ProfilingSimulatorImpl()
+{
+}
+
+EventImpl*
+ProfilingSimulatorImpl::count(EventImpl* event)
+{
+  return new CountedEvent(event, m_nEvents);
+}
+
+EventId
+ProfilingSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+  return DefaultSimulatorImpl::Schedule(delay, count(event));
+}
+
+void
+ProfilingSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event)
+{
+  DefaultSimulatorImpl::ScheduleWithContext(context, delay, count(event));
+}
+
+EventId
+ProfilingSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+  return DefaultSimulatorImpl::ScheduleNow(count(event));
+}
+
+void
+ProfilingSimulatorImpl::Run()
+{
+  if (!m_isStarted) {
+    m_isStarted = true;
+    m_file.open(m_fileName.c_str(), std::ios::out | std::ios::trunc);
+    if (!m_file) {
+      NS_FATAL_ERROR("File " << m_fileName << " cannot be opened for writing");
+    }
+    m_file << "Time\tWallTime\tEvents\tEventRate\tWallPerSimSecond\tPitEntries\tMaxNodePitEntries"
+           << "\tMeasurementsEntries\tMaxNodeMeasurementsEntries\tRssKiB\tPeakRssKiB\n";
+
+    if (!m_nodeFileName.empty()) {
+      m_nodeFile.open(m_nodeFileName.c_str(), std::ios::out | std::ios::trunc);
+      if (!m_nodeFile) {
+        NS_FATAL_ERROR("File " << m_nodeFileName << " cannot be opened for writing");
+      }
+      m_nodeFile << "Time\tNode\tPitEntries\tMeasurementsEntries\n";
+    }
+
+    m_startWall = std::chrono::steady_clock::now();
+    m_lastTime = Now();
+    DefaultSimulatorImpl::Schedule(m_interval,
+                                   MakeEvent(&ProfilingSimulatorImpl::sample, this));
+  }
+
+  DefaultSimulatorImpl::Run();
+
+  // the state at Simulator::Stop
+  if (Now() != m_lastTime) {
+    writeSample();
+  }
+  double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startWall).count();
+  std::cout << "Profile: " << m_nEvents << " events in " << wallTime << " s wall time ("
+            << static_cast<uint64_t>(wallTime > 0 ? m_nEvents / wallTime : 0) << " events/s), "
+            << wallTime / std::max(Now().GetSeconds(), 1e-9) << " s wall time per simulated second, "
+            << "peak RSS " << getPeakRss() / 1024 << " MiB, samples in " << m_fileName << std::endl;
+}
+
+void
+ProfilingSimulatorImpl::Destroy()
+{
+  DefaultSimulatorImpl::Destroy();
+  m_file.close();
+  m_nodeFile.close();
+}
+
+void
+ProfilingSimulatorImpl::sample()
+{
+  writeSample();
+
+  // only keep sampling while the simulation has other events
+  if (!IsFinished()) {
+    DefaultSimulatorImpl::Schedule(m_interval,
+                                   MakeEvent(&ProfilingSimulatorImpl::sample, this));
+  }
+}
+
+void
+ProfilingSimulatorImpl::writeSample()
+{
+  Time now = Now();
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startWall).count();
+  double wallDelta = wall - m_lastWall;
+  double simDelta = (now - m_lastTime).GetSeconds();
+
+  size_t pitEntries = 0;
+  size_t maxPitEntries = 0;
+  size_t measurementsEntries = 0;
+  size_t maxMeasurementsEntries = 0;
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    Ptr<L3Protocol> l3 = (*node)->GetObject<L3Protocol>();
+    if (l3 == nullptr) {
+      continue;
+    }
+    nfd::Forwarder& forwarder = *l3->getForwarder();
+    size_t nodePitEntries = forwarder.getPit().size();
+    size_t nodeMeasurementsEntries = forwarder.getMeasurements().size();
+    pitEntries += nodePitEntries;
+    maxPitEntries = std::max(maxPitEntries, nodePitEntries);
+    measurementsEntries += nodeMeasurementsEntries;
+    maxMeasurementsEntries = std::max(maxMeasurementsEntries, nodeMeasurementsEntries);
+
+    if (m_nodeFile.is_open()) {
+      m_nodeFile << now.GetSeconds() << "\t" << (*node)->GetId() << "\t"
+                 << nodePitEntries << "\t" << nodeMeasurementsEntries << "\n";
+    }
+  }
+
+  m_file << now.GetSeconds() << "\t" << wall << "\t" << m_nEvents << "\t"
+         << (wallDelta > 0 ? (m_nEvents - m_lastEvents) / wallDelta : 0.0) << "\t"
+         << (simDelta > 0 ? wallDelta / simDelta : 0.0) << "\t"
+         << pitEntries << "\t" << maxPitEntries << "\t"
+         << measurementsEntries << "\t" << maxMeasurementsEntries << "\t"
+         << getRss() << "\t" << getPeakRss() << "\n";
+  m_file.flush();
+  m_nodeFile.flush();
+
+  m_lastEvents = m_nEvents;
+  m_lastWall = wall;
+  m_lastTime = now;
+}
+
+} // namespace ndn
+} // namespace ns3
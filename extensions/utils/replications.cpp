@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "replications.hpp"
+#include "mpi-partition.hpp"
+
+#include "ns3/log.h"
+#include "ns3/rng-seed-manager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include <errno.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+NS_LOG_COMPONENT_DEFINE("ndn.Replications");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+struct Replication
+{
+  uint32_t run;
+  std::string dir;
+  std::chrono::steady_clock::time_point start;
+  double wallTime = 0; ///< seconds
+  long maxRss = 0;     ///< KiB
+  int exitCode = -1;
+};
+
+} // namespace
+
+std::string
+Replications::Fork(uint32_t count, uint32_t jobs, const std::string& logDir)
+{
+  if (count <= 1) {
+    return logDir;
+  }
+  if (MpiPartition::IsEnabled()) {
+    NS_FATAL_ERROR("Replications cannot be forked with MPI");
+  }
+  if (jobs == 0) {
+    jobs = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  std::vector<Replication> replications(count);
+  std::map<pid_t, size_t> running;
+
+  // waits for any child, returns false if there is none left
+  auto waitForChild = [&] {
+    int status;
+    struct rusage usage;
+    pid_t pid = wait4(-1, &status, 0, &usage);
+    if (pid < 0) {
+      return false;
+    }
+    auto child = running.find(pid);
+    if (child == running.end()) {
+      return true;
+    }
+    Replication& replication = replications[child->second];
+    replication.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                         replication.start).count();
+    replication.maxRss = usage.ru_maxrss;
+    replication.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    std::cout << "Run " << replication.run << " finished with exit code " << replication.exitCode
+              << " after " << replication.wallTime << " s" << std::endl;
+    running.erase(child);
+    return true;
+  };
+
+  uint32_t firstRun = RngSeedManager::GetRun();
+  for (uint32_t i = 0; i < count; i++) {
+    while (running.size() >= jobs && waitForChild()) {
+    }
+
+    Replication& replication = replications[i];
+    replication.run = firstRun + i;
+    replication.dir = logDir + "run-" + std::to_string(replication.run) + "/";
+    if (mkdir(replication.dir.c_str(), 0755) != 0 && errno != EEXIST) {
+      NS_FATAL_ERROR("Cannot create " << replication.dir);
+    }
+
+    // buffered output would be written again by the child
+    std::cout.flush();
+    std::fflush(nullptr);
+
+    replication.start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+      NS_FATAL_ERROR("Cannot fork replication " << i);
+    }
+    if (pid == 0) {
+      RngSeedManager::SetRun(replication.run);
+      if (chdir(replication.dir.c_str()) != 0 ||
+          std::freopen("stdout.txt", "w", stdout) == nullptr ||
+          dup2(fileno(stdout), STDERR_FILENO) < 0) {
+        std::_Exit(1);
+      }
+      std::cout << "Replication " << i << " of " << count << ", run " << replication.run
+                << std::endl;
+      return "";
+    }
+    running[pid] = i;
+  }
+  while (!running.empty() && waitForChild()) {
+  }
+
+  std::ofstream summary(logDir + "replications.txt");
+  summary << "Run\tDir\tExitCode\tWallTime\tMaxRssKiB\n";
+  uint32_t nFailed = 0;
+  for (const Replication& replication : replications) {
+    summary << replication.run << "\t" << replication.dir << "\t" << replication.exitCode << "\t"
+            << replication.wallTime << "\t" << replication.maxRss << "\n";
+    nFailed += replication.exitCode != 0;
+  }
+  summary.close();
+
+  std::cout << count - nFailed << " of " << count << " replications completed, see "
+            << logDir << "replications.txt" << std::endl;
+  std::exit(nFailed == 0 ? 0 : 1);
+}
+
+} // namespace ndn
+} // namespace ns3
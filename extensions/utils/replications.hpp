@@ -0,0 +1,61 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef REPLICATIONS_H
+#define REPLICATIONS_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Runs independent replications of a scenario in forked processes
+ *
+ * A scenario builds everything that does not depend on the RNG run (topology, stack,
+ * routes, link failures) once and then calls Fork(). Each child continues the scenario
+ * with its own run number (RngSeedManager::SetRun), so random variables created after
+ * the fork (call times, applications) differ, while the topology is shared copy-on-write.
+ *
+ * Replication i uses run --RngRun + i and writes all files into <logDir>run-<run>/,
+ * which becomes its working directory, including its standard output (stdout.txt). The
+ * parent waits for all children, writes <logDir>replications.txt and exits.
+ */
+class Replications
+{
+public:
+  /**
+   * @param count number of replications, 1 runs the scenario in this process
+   * @param jobs replications running at the same time, 0 for the number of cores
+   * @param logDir output directory of the scenario
+   *
+   * @returns in a child, the log directory relative to its working directory (""); with
+   *          count <= 1, @p logDir. The parent does not return.
+   */
+  static std::string
+  Fork(uint32_t count, uint32_t jobs, const std::string& logDir);
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // REPLICATIONS_H
@@ -0,0 +1,311 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "trace-replay.hpp"
+#include "in-memory-face.hpp"
+#include "parameterconfiguration.h"
+
+#include "../apps/data-template.hpp"
+#include "../apps/packet-pool.hpp"
+#include "../tracers/push-tracer.hpp"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include "fw/forwarder.hpp"
+#include "fw/push-counters.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+NS_LOG_COMPONENT_DEFINE("ndn.TraceReplay");
+
+namespace ns3 {
+namespace ndn {
+
+static const char* TYPE_NAMES[] = {"InInterest", "OutInterest", "InData", "OutData",
+                                   "InNack", "OutNack"};
+
+TraceReplay::TraceReplay(nfd::Forwarder& forwarder)
+  : m_forwarder(forwarder)
+{
+}
+
+void
+TraceReplay::load(const std::string& file, const std::string& node)
+{
+  std::FILE* f = std::fopen(file.c_str(), "rb");
+  if (f == nullptr) {
+    NS_FATAL_ERROR("Cannot open trace " << file);
+  }
+  char magic[4] = {};
+  size_t nRead = std::fread(magic, 1, sizeof(magic), f);
+  if (nRead == sizeof(magic) && std::memcmp(magic, "NDNT", 4) == 0) {
+    readBinary(f, node);
+    std::fclose(f);
+  }
+  else {
+    std::fclose(f);
+    std::ifstream is(file);
+    readText(is, node);
+  }
+
+  for (const Record& record : m_records) {
+    m_nTraced[record.type]++;
+  }
+  NS_LOG_INFO(m_records.size() << " records of node " << node << " in " << file);
+  if (m_records.empty()) {
+    NS_FATAL_ERROR("No records of node " << node << " in " << file);
+  }
+}
+
+void
+TraceReplay::readText(std::istream& is, const std::string& node)
+{
+  std::string line;
+  std::string seconds, lineNode, faceId, faceDescr, type, name, bytes;
+  while (std::getline(is, line)) {
+    std::istringstream fields(line);
+    if (!std::getline(fields, seconds, '\t') || !std::getline(fields, lineNode, '\t') ||
+        lineNode != node) {
+      continue;
+    }
+    if (!std::getline(fields, faceId, '\t') || !std::getline(fields, faceDescr, '\t') ||
+        !std::getline(fields, type, '\t') || !std::getline(fields, name, '\t') ||
+        !std::getline(fields, bytes, '\t')) {
+      NS_FATAL_ERROR("Malformed trace line: " << line);
+    }
+
+    auto typeName = std::find(std::begin(TYPE_NAMES), std::end(TYPE_NAMES), type);
+    if (typeName == std::end(TYPE_NAMES)) {
+      continue;
+    }
+    m_records.push_back({static_cast<int64_t>(std::llround(std::stod(seconds) * 1e9)),
+                         static_cast<uint32_t>(std::stoul(faceId)),
+                         static_cast<BinaryTraceWriter::PacketType>(typeName - std::begin(TYPE_NAMES)),
+                         static_cast<uint32_t>(std::stoul(bytes)), Name(name)});
+  }
+}
+
+void
+TraceReplay::readBinary(std::FILE* file, const std::string& node)
+{
+  uint32_t version = 0;
+  if (std::fread(&version, sizeof(version), 1, file) != 1 || version != BinaryTraceWriter::VERSION) {
+    NS_FATAL_ERROR("Unsupported binary trace version " << version);
+  }
+
+  // ids of the strings and of the names already parsed
+  std::unordered_map<uint32_t, std::string> strings;
+  std::unordered_map<uint32_t, Name> names;
+  int tag;
+  while ((tag = std::fgetc(file)) != EOF) {
+    bool isComplete = false;
+    if (tag == 'S') {
+      uint32_t id, length;
+      if (std::fread(&id, sizeof(id), 1, file) == 1 &&
+          std::fread(&length, sizeof(length), 1, file) == 1) {
+        std::string str(length, '\0');
+        isComplete = length == 0 || std::fread(&str[0], 1, length, file) == length;
+        names.erase(id);
+        strings[id] = std::move(str);
+      }
+    }
+    else if (tag == 'P') {
+      int64_t timeNs;
+      uint32_t nodeId, faceId, faceDescr, name, bytes;
+      uint8_t type;
+      isComplete = std::fread(&timeNs, sizeof(timeNs), 1, file) == 1 &&
+                   std::fread(&nodeId, sizeof(nodeId), 1, file) == 1 &&
+                   std::fread(&faceId, sizeof(faceId), 1, file) == 1 &&
+                   std::fread(&faceDescr, sizeof(faceDescr), 1, file) == 1 &&
+                   std::fread(&type, sizeof(type), 1, file) == 1 &&
+                   std::fread(&name, sizeof(name), 1, file) == 1 &&
+                   std::fread(&bytes, sizeof(bytes), 1, file) == 1;
+      if (isComplete && type < N_TYPES && strings[nodeId] == node) {
+        auto parsed = names.find(name);
+        if (parsed == names.end()) {
+          parsed = names.emplace(name, Name(strings[name])).first;
+        }
+        m_records.push_back({timeNs, faceId, static_cast<BinaryTraceWriter::PacketType>(type),
+                             bytes, parsed->second});
+      }
+    }
+    else {
+      NS_FATAL_ERROR("Unknown record type " << tag << " in binary trace");
+    }
+
+    if (!isComplete) {
+      NS_FATAL_ERROR("Truncated binary trace");
+    }
+  }
+}
+
+void
+TraceReplay::prepare()
+{
+  // faces in the order of the trace, routes to the faces the node sent Interests on
+  for (const Record& record : m_records) {
+    if (m_faces.count(record.faceId) == 0) {
+      m_faces[record.faceId] = InMemoryLinkService::AddFace(m_forwarder,
+                                                            "replay://face" + std::to_string(record.faceId));
+      m_faces[record.faceId]->keepSentInterests();
+    }
+  }
+
+  std::map<Name, std::set<uint32_t>> routes;
+  for (const Record& record : m_records) {
+    if (record.type != BinaryTraceWriter::OUT_INTEREST) {
+      continue;
+    }
+    Name prefix = record.name.getPrefix(std::min(m_routePrefixLength, record.name.size()));
+    std::set<uint32_t>& faces = routes[prefix];
+    if (faces.insert(record.faceId).second) {
+      m_forwarder.getFib().insert(prefix).first->addNextHop(m_faces[record.faceId]->getForwarderFace(),
+                                                            faces.size());
+    }
+  }
+
+  DataTemplate pushTemplate;
+  pushTemplate.prepare("push", 0, time::milliseconds(0), Name(), 0);
+  DataTemplate regularTemplate;
+  regularTemplate.prepare("", 0, time::milliseconds(0), Name(), 0);
+  const std::string& probeSuffix = ParameterConfiguration::getInstance()->PROBE_SUFFIX;
+
+  std::set<std::pair<uint32_t, Name>> pis;
+  int64_t start = m_records.front().time;
+  for (const Record& record : m_records) {
+    Step step{record.time - start, m_faces[record.faceId], nullptr, nullptr, nullptr};
+    bool isPush = PushTracer::isPushName(record.name) &&
+                  record.name.toUri().find(probeSuffix) == std::string::npos;
+
+    if (record.type == BinaryTraceWriter::IN_INTEREST) {
+      step.interest = make_shared<Interest>(record.name);
+      step.interest->setNonce(m_random());
+      step.interest->setInterestLifetime(m_interestLifetime);
+      if (isPush) {
+        bool isRefresh = !pis.insert(std::make_pair(record.faceId, record.name)).second;
+        if (isRefresh && m_useRefreshPi) {
+          step.interest->setPushRefresh(true);
+        }
+        else {
+          step.interest->setPush(true);
+        }
+      }
+    }
+    else if (record.type == BinaryTraceWriter::IN_DATA) {
+      const DataTemplate& dataTemplate = isPush ? pushTemplate : regularTemplate;
+      step.data = make_shared<Data>();
+      // the size without content tells the content size that gives the traced size
+      dataTemplate.encode(*step.data, record.name, PacketPool::getVirtualPayload(0));
+      size_t overhead = step.data->wireEncode().size();
+      if (record.bytes > overhead) {
+        dataTemplate.encode(*step.data, record.name,
+                            PacketPool::getVirtualPayload(record.bytes - overhead));
+      }
+    }
+    else if (record.type == BinaryTraceWriter::IN_NACK) {
+      step.nackName = &record.name;
+    }
+    else {
+      continue;
+    }
+    m_steps.push_back(step);
+  }
+}
+
+void
+TraceReplay::run(double speed)
+{
+  prepare();
+
+  auto start = std::chrono::steady_clock::now();
+  for (const Step& step : m_steps) {
+    int64_t now = Simulator::Now().GetNanoSeconds();
+    if (step.time > now) {
+      // expire the forwarder's timers up to the time of the packet
+      Simulator::Stop(NanoSeconds(step.time - now));
+      Simulator::Run();
+    }
+    if (speed > 0) {
+      std::this_thread::sleep_until(start + std::chrono::nanoseconds(
+                                              static_cast<int64_t>(step.time / speed)));
+    }
+
+    if (step.interest != nullptr) {
+      step.face->injectInterest(*step.interest);
+      m_nInjected[BinaryTraceWriter::IN_INTEREST]++;
+    }
+    else if (step.data != nullptr) {
+      step.face->injectData(*step.data);
+      m_nInjected[BinaryTraceWriter::IN_DATA]++;
+    }
+    else {
+      shared_ptr<Interest> interest = step.face->takeSentInterest(*step.nackName);
+      if (interest == nullptr) {
+        // the forwarder did not send this Interest on the face
+        m_nUnmatchedNacks++;
+        continue;
+      }
+      lp::Nack nack(*interest);
+      nack.setReason(m_nackReason);
+      step.face->injectNack(nack);
+      m_nInjected[BinaryTraceWriter::IN_NACK]++;
+    }
+  }
+  m_wallTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now() - start).count();
+}
+
+void
+TraceReplay::printSummary(std::ostream& os) const
+{
+  uint64_t nReplayed[N_TYPES] = {};
+  std::copy(std::begin(m_nInjected), std::end(m_nInjected), std::begin(nReplayed));
+  for (const auto& face : m_faces) {
+    nReplayed[BinaryTraceWriter::OUT_INTEREST] += face.second->nSentInterests;
+    nReplayed[BinaryTraceWriter::OUT_DATA] += face.second->nSentData;
+    nReplayed[BinaryTraceWriter::OUT_NACK] += face.second->nSentNacks;
+  }
+
+  double nPackets = m_steps.size();
+  os << "Replayed " << m_steps.size() << " packets on " << m_faces.size() << " faces in "
+     << m_wallTime / 1e6 << " ms, "
+     << (m_wallTime == 0 ? 0.0 : nPackets * 1e9 / m_wallTime) << " packets/s, "
+     << (nPackets == 0 ? 0.0 : m_wallTime / nPackets) << " ns/packet\n";
+  os << "Type\tTrace\tReplay\n";
+  for (size_t type = 0; type < N_TYPES; type++) {
+    os << TYPE_NAMES[type] << "\t" << m_nTraced[type] << "\t" << nReplayed[type] << "\n";
+  }
+
+  const nfd::fw::PushCounters& pushCounters = m_forwarder.getPushCounters();
+  os << "LoopingDrops: " << pushCounters.nLoopingDrops
+     << ", DuplicateDeliveries: " << pushCounters.nDuplicateDeliveries
+     << ", UnmatchedNacks: " << m_nUnmatchedNacks << "\n";
+}
+
+} // namespace ndn
+} // namespace ns3
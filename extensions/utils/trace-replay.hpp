@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "../tracers/binary-trace-writer.hpp"
+
+#include <cstdio>
+#include <map>
+#include <ostream>
+#include <random>
+#include <vector>
+
+namespace nfd {
+class Forwarder;
+} // namespace nfd
+
+namespace ns3 {
+namespace ndn {
+
+class InMemoryLinkService;
+
+/**
+ * @ingroup ndn-helpers
+ * @brief Re-drives the forwarder of a single node with the packets of a packet trace
+ *
+ * The incoming Interests, Data and Nacks of one node are read from a packet trace of
+ * L3PacketTracer, either the TSV format of InstallAll() or the binary format of
+ * InstallAllBinary(), and injected into a stand-alone forwarder with the original timing.
+ * Every face id of the trace becomes an InMemoryLinkService face.
+ *
+ * A trace only has names, so the packets are rebuilt:
+ * - Interests get a nonce of a seeded random generator. Interests with a push name
+ *   (PushTracer::isPushName) that are not probes are PIs, repeated PIs of a face are RPIs
+ *   if setUseRefreshPi() is set. Loops of regular Interests are therefore not reproduced,
+ *   loops of push Data are, as the bitvector only looks at the sequence numbers.
+ * - Data have the size of the trace, with the "push" message type for push names.
+ * - Nacks carry the last Interest the forwarder sent for the name on their face, so that
+ *   the nonce matches the out-record.
+ * - The FIB has a route for the first routePrefixLength components of every Interest the
+ *   node sent, to the faces in the order they were first used (costs 1, 2, ...).
+ *
+ * Only the forwarder's timers are in the ns-3 event queue, which is run up to the time
+ * of each packet. The replay runs at maximal speed or paced to a multiple of real time.
+ */
+class TraceReplay
+{
+public:
+  struct Record
+  {
+    int64_t time; ///< nanoseconds
+    uint32_t faceId;
+    BinaryTraceWriter::PacketType type;
+    uint32_t bytes;
+    Name name;
+  };
+
+  explicit
+  TraceReplay(nfd::Forwarder& forwarder);
+
+  /**
+   * @brief Reads the records of @p node (name or id as written by the tracer)
+   *
+   * The format is detected from the file, aborts if it cannot be read.
+   */
+  void
+  load(const std::string& file, const std::string& node);
+
+  void
+  setRoutePrefixLength(size_t length)
+  {
+    m_routePrefixLength = length;
+  }
+
+  void
+  setInterestLifetime(time::milliseconds lifetime)
+  {
+    m_interestLifetime = lifetime;
+  }
+
+  void
+  setUseRefreshPi(bool useRefreshPi)
+  {
+    m_useRefreshPi = useRefreshPi;
+  }
+
+  void
+  setNackReason(lp::NackReason reason)
+  {
+    m_nackReason = reason;
+  }
+
+  void
+  setSeed(uint32_t seed)
+  {
+    m_random.seed(seed);
+  }
+
+  /**
+   * @brief Creates faces, routes and packets, then injects the packets
+   *
+   * @param speed 0 for maximal speed, otherwise simulated seconds per wall clock second
+   */
+  void
+  run(double speed);
+
+  /**
+   * @brief Writes the replay rate and compares the packets sent by the forwarder with
+   *        the outgoing packets of the trace
+   */
+  void
+  printSummary(std::ostream& os) const;
+
+private:
+  void
+  readText(std::istream& is, const std::string& node);
+
+  void
+  readBinary(std::FILE* file, const std::string& node);
+
+  void
+  prepare();
+
+private:
+  struct Step
+  {
+    int64_t time; ///< nanoseconds since the first record
+    InMemoryLinkService* face;
+    shared_ptr<Interest> interest;
+    shared_ptr<Data> data;
+    const Name* nackName;
+  };
+
+  static const size_t N_TYPES = 6;
+
+  nfd::Forwarder& m_forwarder;
+  std::vector<Record> m_records;
+  std::map<uint32_t, InMemoryLinkService*> m_faces;
+  std::vector<Step> m_steps;
+
+  size_t m_routePrefixLength = 2;
+  time::milliseconds m_interestLifetime = time::milliseconds(2000);
+  bool m_useRefreshPi = false;
+  lp::NackReason m_nackReason = lp::NackReason::NO_ROUTE;
+  std::mt19937 m_random;
+
+  uint64_t m_nTraced[N_TYPES] = {};
+  uint64_t m_nInjected[N_TYPES] = {};
+  uint64_t m_nUnmatchedNacks = 0;
+  int64_t m_wallTime = 0; ///< nanoseconds
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif // TRACE_REPLAY_H
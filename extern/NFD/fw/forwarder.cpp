@@ -27,11 +27,16 @@
 #include "algorithm.hpp"
 #include "core/logger.hpp"
 #include "strategy.hpp"
+#include "loop-nack-cache.hpp"
+#include "push-nonce-memory.hpp"
+#include "push-counters.hpp"
 #include "table/cleanup.hpp"
 #include <ndn-cxx/lp/tags.hpp>
 #include "face/null-face.hpp"
 #include <boost/random/uniform_int_distribution.hpp>
 
+#include <chrono>
+
 namespace nfd {
 
 NFD_LOG_INIT("Forwarder");
@@ -135,8 +140,25 @@ Forwarder::onIncomingInterest(Face& inFace, const Interest& interest)
     return;
   }
 
+  bool isPushInDnlSkipped = m_pushNonceMemory.isDnlSkipped() &&
+                            (interest.isPush() || interest.isPushRefresh());
+
   // detect duplicate Nonce with Dead Nonce List
-  bool hasDuplicateNonceInDnl = m_deadNonceList.has(interest.getName(), interest.getNonce());
+  bool hasDuplicateNonceInDnl = false;
+  if (isPushInDnlSkipped) {
+    hasDuplicateNonceInDnl = m_pushNonceMemory.filter.has(interest.getName(), interest.getNonce());
+  }
+  else if (m_pushNonceMemory.isDnlLookupTimed()) {
+    auto lookupStart = std::chrono::steady_clock::now();
+    hasDuplicateNonceInDnl = m_deadNonceList.has(interest.getName(), interest.getNonce());
+    m_pushNonceMemory.dnlLookupNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - lookupStart).count();
+    ++m_pushNonceMemory.nDnlLookups;
+  }
+  else {
+    hasDuplicateNonceInDnl = m_deadNonceList.has(interest.getName(), interest.getNonce());
+    ++m_pushNonceMemory.nDnlLookups;
+  }
   if (hasDuplicateNonceInDnl) {
     // goto Interest loop pipeline
     this->onInterestLoop(inFace, interest);
@@ -155,6 +177,17 @@ Forwarder::onIncomingInterest(Face& inFace, const Interest& interest)
     return;
   }
 
+  // detect duplicate Nonce among the earlier refreshes of a PI
+  if (isPushInDnlSkipped) {
+    if (pitEntry->hasPushNonce(interest.getNonce(), inFace.getId())) {
+      ++m_pushNonceMemory.nRingHits;
+      // goto Interest loop pipeline
+      this->onInterestLoop(inFace, interest);
+      return;
+    }
+    pitEntry->addPushNonce(interest.getNonce(), inFace.getId());
+  }
+
   // cancel unsatisfy & straggler timer
   this->cancelUnsatisfyAndStragglerTimer(*pitEntry);
 
@@ -198,9 +231,8 @@ Forwarder::onInterestLoop(Face& inFace, const Interest& interest)
 
   // send Nack with reason=DUPLICATE
   // note: Don't enter outgoing Nack pipeline because it needs an in-record.
-  lp::Nack nack(interest);
-  nack.setReason(lp::NackReason::DUPLICATE);
-  inFace.sendNack(nack);
+  // During loop storms the same Interest loops many times, reuse the Nack built for it.
+  inFace.sendNack(m_loopNackCache.get(interest, lp::NackReason::DUPLICATE));
 }
 
 void
@@ -233,9 +265,23 @@ Forwarder::onContentStoreMiss(const Face& inFace, const shared_ptr<pit::Entry>&
     return;
   }
 
+  // a refresh of a PI that is pending upstream may be coalesced by the strategy
+  bool isPushRefresh = (interest.isPush() || interest.isPushRefresh()) &&
+                       fw::hasPendingOutRecords(*pitEntry);
+  uint64_t nOutInterests = m_counters.nOutInterests;
+
   // dispatch to strategy: after incoming Interest
   this->dispatchToStrategy(*pitEntry,
     [&] (fw::Strategy& strategy) { strategy.afterReceiveInterest(inFace, interest, pitEntry); });
+
+  if (isPushRefresh) {
+    if (m_counters.nOutInterests != nOutInterests) {
+      ++m_pushCounters.nForwardedRefreshes;
+    }
+    else {
+      ++m_pushCounters.nCoalescedRefreshes;
+    }
+  }
 }
 
 void
@@ -369,10 +415,17 @@ Forwarder::onIncomingData(Face& inFace, const Data& data)
       uint32_t seq = data.getName().at(-1).toSequenceNumber();
       if (pitEntry->isLooping(seq)) {
         NFD_LOG_DEBUG("onIncomingData loopingPacket " << data.getName());
+        ++m_pushCounters.nLoopingDrops;
         // drop
         return;
       } else {
+        if (pitEntry->isOutsideLoopWindow(seq)) {
+          ++m_pushCounters.nBitvectorWindowMisses;
+        }
         pitEntry->addSequenceNumber(seq);
+        if (pitEntry->addDeliveredSequenceNumber(seq)) {
+          m_pushCounters.addDuplicateDelivery(pitEntry->getName());
+        }
       }
     }
 
@@ -529,10 +582,8 @@ Forwarder::onOutgoingNack(const shared_ptr<pit::Entry>& pitEntry, const Face& ou
     NFD_LOG_DEBUG("onOutgoingNack face=" << outFace.getId() <<
                 " nack=" << pitEntry->getInterest().getName() <<
                 "~" << nack.getReason() << " OK");
-    lp::Nack nackPkt(pitEntry->getInterest());
-    nackPkt.setHeader(nack);
-    // send Nack on face
-    const_cast<Face&>(outFace).sendNack(nackPkt);
+    // send Nack on face, the teardown Nack is built once per PIT entry
+    const_cast<Face&>(outFace).sendNack(pitEntry->getTeardownNack());
     ++m_counters.nOutNacks;
     return;
   }
@@ -648,6 +699,22 @@ Forwarder::insertDeadNonceList(pit::Entry& pitEntry, bool isSatisfied,
     return;
   }
 
+  const Interest& interest = pitEntry.getInterest();
+  if (m_pushNonceMemory.isDnlSkipped() && (interest.isPush() || interest.isPushRefresh())) {
+    ++m_pushNonceMemory.nDnlInsertsSkipped;
+    if (upstream == 0) {
+      // the entry is finalized, its ring is gone with it
+      for (const pit::OutRecord& outRecord : pitEntry.getOutRecords()) {
+        m_pushNonceMemory.filter.add(pitEntry.getName(), outRecord.getLastNonce());
+      }
+      pitEntry.forEachPushNonce([&] (uint32_t nonce) {
+        m_pushNonceMemory.filter.add(pitEntry.getName(), nonce);
+      });
+    }
+    return;
+  }
+  ++m_pushNonceMemory.nDnlInserts;
+
   // Dead Nonce List insert
   if (upstream == 0) {
     // insert all outgoing Nonces
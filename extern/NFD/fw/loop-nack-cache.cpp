@@ -0,0 +1,68 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2016,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "loop-nack-cache.hpp"
+
+#include <ndn-cxx/lp/tags.hpp>
+
+namespace nfd {
+namespace fw {
+
+LoopNackCache::LoopNackCache(size_t nSlots)
+  : m_slots(nSlots)
+  , m_nHits(0)
+  , m_nMisses(0)
+{
+  BOOST_ASSERT(nSlots > 0);
+}
+
+const lp::Nack&
+LoopNackCache::get(const Interest& interest, lp::NackReason reason)
+{
+  uint32_t nonce = interest.getNonce();
+  size_t index = (nonce * 2654435761u ^ interest.getName().size()) % m_slots.size();
+
+  shared_ptr<lp::Nack>& slot = m_slots[index];
+  if (slot != nullptr &&
+      slot->getReason() == reason &&
+      slot->getInterest().getNonce() == nonce &&
+      slot->getInterest().getName() == interest.getName() &&
+      slot->getInterest().getSelectors() == interest.getSelectors()) {
+    ++m_nHits;
+    return *slot;
+  }
+
+  ++m_nMisses;
+  slot = make_shared<lp::Nack>(interest);
+  slot->setHeader(lp::NackHeader(reason));
+
+  // tags describe the hop the Interest arrived on and must not leak to other forwarders
+  slot->getInterest().removeTag<lp::IncomingFaceIdTag>();
+  slot->getInterest().removeTag<lp::HopCountTag>();
+  return *slot;
+}
+
+} // namespace fw
+} // namespace nfd
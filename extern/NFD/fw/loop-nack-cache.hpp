@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2016,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_FW_LOOP_NACK_CACHE_HPP
+#define NFD_DAEMON_FW_LOOP_NACK_CACHE_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/lp/nack.hpp>
+
+namespace nfd {
+namespace fw {
+
+/** \brief remembers the Nack packets recently sent for looping Interests
+ *
+ *  During a loop storm the same Interest (same Name and Nonce) arrives over and over
+ *  again on different faces. Instead of copying the Interest into a new lp::Nack for
+ *  every arrival, the Nack built for the first arrival is kept in a small direct-mapped
+ *  cache and sent again. The header uses the pre-encoded NackHeader of its reason.
+ *
+ *  Each forwarder owns one cache, so it is released together with the forwarder.
+ */
+class LoopNackCache : noncopyable
+{
+public:
+  explicit
+  LoopNackCache(size_t nSlots = 256);
+
+  /** \return a Nack packet for \p interest with \p reason
+   */
+  const lp::Nack&
+  get(const Interest& interest, lp::NackReason reason);
+
+  uint64_t
+  getHits() const
+  {
+    return m_nHits;
+  }
+
+  uint64_t
+  getMisses() const
+  {
+    return m_nMisses;
+  }
+
+private:
+  std::vector<shared_ptr<lp::Nack>> m_slots;
+  uint64_t m_nHits;
+  uint64_t m_nMisses;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_DAEMON_FW_LOOP_NACK_CACHE_HPP
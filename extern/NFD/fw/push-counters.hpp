@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2016,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_FW_PUSH_COUNTERS_HPP
+#define NFD_DAEMON_FW_PUSH_COUNTERS_HPP
+
+#include "common.hpp"
+
+#include <map>
+
+namespace nfd {
+namespace fw {
+
+/** \brief per-forwarder counters of the Data loop prevention for Persistent Interests
+ */
+class PushCounters : noncopyable
+{
+public:
+  /** \brief counts a push Data that passed the bitvector although its sequence number
+   *         was seen before for \p prefix
+   */
+  void
+  addDuplicateDelivery(const Name& prefix)
+  {
+    ++nDuplicateDeliveries;
+    ++duplicateDeliveriesByPrefix[prefix];
+  }
+
+public:
+  /** \brief push Data dropped because the bitvector detected a loop
+   */
+  uint64_t nLoopingDrops = 0;
+
+  /** \brief push Data with a sequence number older than the bitvector window,
+   *         a loop of these packets is not detected
+   */
+  uint64_t nBitvectorWindowMisses = 0;
+
+  /** \brief push Data forwarded again with a sequence number seen before
+   */
+  uint64_t nDuplicateDeliveries = 0;
+  std::map<Name, uint64_t> duplicateDeliveriesByPrefix;
+
+  /** \brief refreshes of Persistent Interests that were already forwarded upstream,
+   *         split into those the strategy forwarded again and those it did not
+   *
+   *  Counted with and without PI_REFRESH_COALESCING, see RetxSuppressionPush.
+   */
+  uint64_t nForwardedRefreshes = 0;
+  uint64_t nCoalescedRefreshes = 0;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_DAEMON_FW_PUSH_COUNTERS_HPP
@@ -0,0 +1,104 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2016,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_FW_PUSH_NONCE_MEMORY_HPP
+#define NFD_DAEMON_FW_PUSH_NONCE_MEMORY_HPP
+
+#include "common.hpp"
+#include "../table/push-nonce-filter.hpp"
+
+namespace nfd {
+namespace fw {
+
+/** \brief per-forwarder Nonce memory of Persistent Interests and Dead Nonce List statistics
+ *
+ *  If the PUSH_SKIP_DNL parameter is set, the forwarder does not insert the Nonces of push
+ *  PIT entries into its Dead Nonce List. The refresh Nonces of a live entry are kept in the
+ *  entry, those of a finalized entry in the PushNonceFilter of this object.
+ *
+ *  The wall clock time of Dead Nonce List lookups is only measured if TIME_DNL_LOOKUPS is set.
+ *  Both parameters are read when the forwarder is created.
+ */
+class PushNonceMemory : noncopyable
+{
+public:
+  PushNonceMemory();
+
+  /** \return whether Nonces of push PIT entries bypass the Dead Nonce List
+   */
+  bool
+  isDnlSkipped() const
+  {
+    return m_isDnlSkipped;
+  }
+
+  /** \return whether the wall clock time of Dead Nonce List lookups is measured
+   */
+  bool
+  isDnlLookupTimed() const
+  {
+    return m_isDnlLookupTimed;
+  }
+
+  /** \return estimated memory used by a Dead Nonce List with \p nEntries entries in bytes
+   *
+   *  Each entry is a 64-bit hash in a multi-index container with a sequenced and a hashed
+   *  index, i.e. three pointers of overhead plus its share of the bucket array.
+   */
+  static size_t
+  estimateDnlMemoryUsage(size_t nEntries)
+  {
+    return nEntries * (sizeof(uint64_t) + 4 * sizeof(void*));
+  }
+
+public:
+  PushNonceFilter filter;
+
+  /** \brief Dead Nonce List lookups and the wall clock time spent in them
+   *
+   *  time::steady_clock is the simulated clock in ndnSIM, the time is taken with std::chrono.
+   *  dnlLookupNanoseconds stays 0 unless isDnlLookupTimed().
+   */
+  uint64_t nDnlLookups = 0;
+  uint64_t dnlLookupNanoseconds = 0;
+
+  /** \brief Dead Nonce List inserts done and skipped for push PIT entries
+   */
+  uint64_t nDnlInserts = 0;
+  uint64_t nDnlInsertsSkipped = 0;
+
+  /** \brief looping push Interests detected by the ring of a PIT entry
+   */
+  uint64_t nRingHits = 0;
+
+private:
+  bool m_isDnlSkipped;
+  bool m_isDnlLookupTimed;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_DAEMON_FW_PUSH_NONCE_MEMORY_HPP
@@ -73,8 +73,12 @@ RetxSuppression::Result
 RetxSuppressionExponential::decide(const Face& inFace, const Interest& interest,
                                    pit::Entry& pitEntry) const
 {
+  if (interest.isPush() || interest.isPushRefresh()) {
+    return m_pushSuppression.decide(inFace, interest, pitEntry);
+  }
+
   bool isNewPitEntry = !hasPendingOutRecords(pitEntry);
-  if (isNewPitEntry || interest.isPush() || interest.isPushRefresh()) { 
+  if (isNewPitEntry) {
     return NEW;
   }
 
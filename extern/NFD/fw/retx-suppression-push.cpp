@@ -0,0 +1,125 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2016,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "retx-suppression-push.hpp"
+#include "algorithm.hpp"
+#include "core/logger.hpp"
+#include "../mgmt/parameterconfiguration.hpp"
+
+namespace nfd {
+namespace fw {
+
+NFD_LOG_INIT("RetxSuppressionPush");
+
+class RetxSuppressionPush::PitInfo : public StrategyInfo
+{
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 1090;
+  }
+
+public:
+  /** \brief arrival time of the last refresh per downstream face
+   */
+  std::unordered_map<FaceId, time::steady_clock::TimePoint> lastRefresh;
+
+  /** \brief largest observed interval between two refreshes of the same downstream
+   */
+  time::steady_clock::Duration maxRefreshInterval = time::steady_clock::Duration::zero();
+
+  /** \brief number of refreshes of this PIT entry that were not forwarded
+   */
+  uint64_t nSuppressed = 0;
+};
+
+static time::steady_clock::TimePoint
+getUpstreamExpiry(const pit::Entry& pitEntry)
+{
+  time::steady_clock::TimePoint expiry = time::steady_clock::TimePoint::min();
+  for (const pit::OutRecord& outRecord : pitEntry.getOutRecords()) {
+    expiry = std::max(expiry, outRecord.getExpiry());
+  }
+  return expiry;
+}
+
+RetxSuppressionPush::RetxSuppressionPush()
+  : m_coalescingFraction(ParameterConfiguration::getInstance()->getParameter("PI_REFRESH_COALESCING"))
+{
+}
+
+RetxSuppression::Result
+RetxSuppressionPush::decide(const Face& inFace, const Interest& interest,
+                            pit::Entry& pitEntry) const
+{
+  if (m_coalescingFraction <= 0 || !hasPendingOutRecords(pitEntry)) {
+    return NEW;
+  }
+
+  time::steady_clock::TimePoint now = time::steady_clock::now();
+  time::steady_clock::Duration lifetime = interest.getInterestLifetime();
+  if (lifetime <= time::steady_clock::Duration::zero()) {
+    lifetime = DEFAULT_INTEREST_LIFETIME;
+  }
+
+  PitInfo* pi = pitEntry.insertStrategyInfo<PitInfo>().first;
+  auto lastRefresh = pi->lastRefresh.find(inFace.getId());
+  if (lastRefresh != pi->lastRefresh.end()) {
+    pi->maxRefreshInterval = std::min(lifetime, std::max(pi->maxRefreshInterval,
+                                                         now - lastRefresh->second));
+    lastRefresh->second = now;
+  }
+  else {
+    pi->lastRefresh.emplace(inFace.getId(), now);
+  }
+
+  time::steady_clock::Duration coalescingWindow =
+    time::duration_cast<time::steady_clock::Duration>(lifetime * m_coalescingFraction);
+  time::steady_clock::Duration sinceLastOutgoing = now - this->getLastOutgoing(pitEntry);
+
+  // until a refresh interval has been observed, assume the next refresh arrives when the
+  // coalescing window is over
+  time::steady_clock::Duration nextRefreshDue = pi->maxRefreshInterval;
+  if (nextRefreshDue == time::steady_clock::Duration::zero()) {
+    nextRefreshDue = lifetime - coalescingWindow;
+  }
+  bool upstreamWouldLapse = getUpstreamExpiry(pitEntry) - now <= nextRefreshDue;
+
+  if (sinceLastOutgoing < coalescingWindow && !upstreamWouldLapse) {
+    ++pi->nSuppressed;
+    NFD_LOG_DEBUG("suppress refresh " << interest.getName() << " from=" << inFace.getId() <<
+                  " sinceLastOutgoing=" << time::duration_cast<time::milliseconds>(sinceLastOutgoing) <<
+                  " suppressed=" << pi->nSuppressed);
+    return SUPPRESS;
+  }
+
+  // NEW rather than FORWARD: strategies route a forwarded refresh exactly like before,
+  // e.g. best-route must not move the PI to another upstream
+  return NEW;
+}
+
+} // namespace fw
+} // namespace nfd
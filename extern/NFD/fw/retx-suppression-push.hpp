@@ -0,0 +1,66 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2016,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_FW_RETX_SUPPRESSION_PUSH_HPP
+#define NFD_DAEMON_FW_RETX_SUPPRESSION_PUSH_HPP
+
+#include "retx-suppression.hpp"
+
+namespace nfd {
+namespace fw {
+
+/** \brief retransmission suppression for refreshes of Persistent Interests
+ *
+ *  Every downstream refreshes its PI periodically. Without suppression each refresh is
+ *  forwarded upstream, so the upstream load grows with the downstream fan-in.
+ *  This policy coalesces the refreshes of one PIT entry: a refresh is forwarded only if
+ *  the last forwarded refresh is older than a fraction of the Interest lifetime, or if the
+ *  upstream PI would otherwise expire before the next refresh of any downstream is due.
+ *
+ *  The fraction is the PI_REFRESH_COALESCING parameter of ParameterConfiguration, read
+ *  when the policy is built; 0 disables coalescing and every push Interest is treated as NEW.
+ *
+ *  The forwarder counts the forwarded and the coalesced refreshes in its PushCounters.
+ */
+class RetxSuppressionPush : public RetxSuppression
+{
+public:
+  RetxSuppressionPush();
+
+  /** \brief determines whether a push Interest is forwarded (NEW) or suppressed (SUPPRESS)
+   */
+  Result
+  decide(const Face& inFace, const Interest& interest, pit::Entry& pitEntry) const override;
+
+private:
+  class PitInfo;
+
+  const double m_coalescingFraction;
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif // NFD_DAEMON_FW_RETX_SUPPRESSION_PUSH_HPP
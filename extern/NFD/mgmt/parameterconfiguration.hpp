@@ -30,6 +30,9 @@
 #define P_REQUIREMENT_MAXLOSS           0.1    // maximum tolerated loss in percentage
 #define P_REQUIREMENT_MINBANDWIDTH      0.0    // minimum tolerated bandwith in Kbps
 #define P_RTT_TIME_TABLE_MAX_DURATION   1000   // maximum time (in milliseconds) an entry is kept in the rttMap before being erased
+#define P_PI_REFRESH_COALESCING         0.0    // fraction of the Interest lifetime within which PI refreshes are coalesced; 0=disabled
+#define P_PUSH_SKIP_DNL                 0      // if 1, Nonces of Persistent Interests are kept in the PIT entry and a cuckoo filter instead of the Dead Nonce List
+#define P_TIME_DNL_LOOKUPS              0      // if 1, the forwarders measure the wall clock time of Dead Nonce List lookups
 
 /**
  * The ParameterConfiguration class is used to set/get parameters to configure the lowest-cost-strategy.
@@ -16,6 +16,14 @@ class BitmaskLoopDetection {
 
   int size() const { return m_size; }
 
+  /**
+   * True if the sequence number is too old to be tracked by the bitvector, i.e. a loop of
+   * this packet can not be detected.
+   */
+  bool IsOutsideWindow(const unsigned long sequenceNumber) const {
+    return m_size > 1 && sequenceNumber + m_size <= m_highestSequenceNumber;
+  }
+
   void Add(const unsigned long sequenceNumber) {
 
     if (m_size <= 1) {
@@ -23,11 +31,11 @@ class BitmaskLoopDetection {
     }
 
     if (sequenceNumber < m_highestSequenceNumber) { // Received packet has not the highest seq no
-      long pos = m_size - (m_highestSequenceNumber - sequenceNumber);
-      if (pos < 0) {
+      if (IsOutsideWindow(sequenceNumber)) {
         return;
       }
-      m_bits[pos] = 1;
+      // the highest sequence number is stored at m_size - 1
+      m_bits[m_size - 1 - (m_highestSequenceNumber - sequenceNumber)] = 1;
 
 
     } else { // Received packet with higher sequence number
@@ -45,7 +53,7 @@ class BitmaskLoopDetection {
       return false;
     }
 
-    if (sequenceNumber < (m_highestSequenceNumber - m_size + 1)) { // Already forgot old sequence number
+    if (IsOutsideWindow(sequenceNumber)) { // Already forgot old sequence number
       return false; // Default allow
     }
 
@@ -32,7 +32,10 @@ namespace pit {
 Entry::Entry(const Interest& interest)
   : m_interest(interest.shared_from_this())
   , m_nameTreeEntry(nullptr)
+  , m_nPushNonces(0)
+  , m_nextPushNonce(0)
   , m_bld(1)
+  , m_deliveries(1)
 {
   if (m_interest->isPush()) {
     unsigned int bitvector_size = 1;
@@ -42,6 +45,7 @@ Entry::Entry(const Interest& interest)
     }
     bld::BitmaskLoopDetection bld(bitvector_size); 
     m_bld = bld;
+    m_deliveries = bld::BitmaskLoopDetection(DELIVERY_WINDOW);
   }
 }
 
@@ -57,6 +61,35 @@ Entry::canMatch(const Interest& interest, size_t nEqualNameComps) const
   /// \todo #3162 match Link field
 }
 
+void
+Entry::addPushNonce(uint32_t nonce, FaceId faceId)
+{
+  m_pushNonces[m_nextPushNonce] = std::make_pair(nonce, faceId);
+  m_nextPushNonce = (m_nextPushNonce + 1) % PUSH_NONCE_RING_SIZE;
+  if (m_nPushNonces < PUSH_NONCE_RING_SIZE) {
+    ++m_nPushNonces;
+  }
+}
+
+bool
+Entry::hasPushNonce(uint32_t nonce, FaceId faceId) const
+{
+  return std::any_of(m_pushNonces.begin(), m_pushNonces.begin() + m_nPushNonces,
+    [=] (const std::pair<uint32_t, FaceId>& entry) {
+      return entry.first == nonce && entry.second != faceId;
+    });
+}
+
+const lp::Nack&
+Entry::getTeardownNack() const
+{
+  if (m_teardownNack == nullptr) {
+    m_teardownNack.reset(new lp::Nack(*m_interest));
+    m_teardownNack->setHeader(lp::NackHeader(lp::NackReason::PI_TEARDOWN));
+  }
+  return *m_teardownNack;
+}
+
 InRecordCollection::iterator
 Entry::getInRecord(const Face& face)
 {
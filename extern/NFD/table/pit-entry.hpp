@@ -32,6 +32,10 @@
 #include "bld.hpp"
 #include "../mgmt/parameterconfiguration.hpp"
 
+#include <ndn-cxx/lp/nack.hpp>
+
+#include <array>
+
 namespace nfd {
 
 namespace name_tree {
@@ -164,6 +168,59 @@ public: // in-record
     return m_bld.Contains(sequenceNumber);
   }
 
+  /** \return whether \p sequenceNumber is too old for the bitvector, i.e. whether
+   *          isLooping() can not tell if the packet is looping
+   */
+  bool
+  isOutsideLoopWindow(const unsigned long sequenceNumber) const {
+    return m_bld.IsOutsideWindow(sequenceNumber);
+  }
+
+  /** \brief records that Data with \p sequenceNumber passed this entry
+   *  \return whether the sequence number passed before
+   *
+   *  Independent of the bitvector length, the last DELIVERY_WINDOW sequence numbers are
+   *  tracked to count the duplicates which are not prevented by the bitvector.
+   */
+  bool
+  addDeliveredSequenceNumber(const unsigned long sequenceNumber) {
+    bool isDuplicate = m_deliveries.Contains(sequenceNumber);
+    m_deliveries.Add(sequenceNumber);
+    return isDuplicate;
+  }
+
+  /** \brief remembers the Nonce of a push Interest received from \p faceId
+   *
+   *  A PI is refreshed with a new Nonce every few seconds, the in- and out-records only
+   *  keep the latest one. The last PUSH_NONCE_RING_SIZE Nonces are kept here, so that a
+   *  looping refresh is detected without a Dead Nonce List entry per refresh.
+   */
+  void
+  addPushNonce(uint32_t nonce, FaceId faceId);
+
+  /** \return whether \p nonce was recently received on a face other than \p faceId
+   */
+  bool
+  hasPushNonce(uint32_t nonce, FaceId faceId) const;
+
+  /** \brief calls \p f with every remembered push Nonce
+   */
+  template<typename F>
+  void
+  forEachPushNonce(const F& f) const
+  {
+    for (size_t i = 0; i < m_nPushNonces; ++i) {
+      f(m_pushNonces[i].first);
+    }
+  }
+
+  /** \return a PI_TEARDOWN Nack for the representative Interest
+   *
+   *  The Nack is created on first use and shared by all teardowns sent for this entry.
+   */
+  const lp::Nack&
+  getTeardownNack() const;
+
 public: // out-record
   /** \return collection of in-records
    */
@@ -256,10 +313,20 @@ private:
 
   name_tree::Entry* m_nameTreeEntry;
 
+  mutable unique_ptr<lp::Nack> m_teardownNack;
+
+  static const size_t PUSH_NONCE_RING_SIZE = 8;
+  std::array<std::pair<uint32_t, FaceId>, PUSH_NONCE_RING_SIZE> m_pushNonces;
+  uint8_t m_nPushNonces;
+  uint8_t m_nextPushNonce;
+
   friend class name_tree::Entry;
 
 protected:
   bld::BitmaskLoopDetection m_bld;
+
+  static const unsigned int DELIVERY_WINDOW = 1024;
+  bld::BitmaskLoopDetection m_deliveries;
 };
 
 } // namespace pit
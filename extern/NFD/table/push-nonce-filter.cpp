@@ -0,0 +1,196 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2016,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "push-nonce-filter.hpp"
+
+#include <boost/functional/hash.hpp>
+
+namespace nfd {
+
+const size_t PushNonceFilter::DEFAULT_N_BUCKETS = 4096;
+const time::nanoseconds PushNonceFilter::DEFAULT_LIFETIME = time::seconds(6);
+
+PushNonceFilter::PushNonceFilter(size_t nBuckets, const time::nanoseconds& lifetime)
+  : m_nBuckets(1)
+  , m_lifetime(lifetime)
+  , m_lastRotation(time::steady_clock::now())
+  , m_kickSeed(0)
+  , m_nLookups(0)
+  , m_nHits(0)
+  , m_nInserts(0)
+  , m_nEarlyRotations(0)
+{
+  while (m_nBuckets < nBuckets) {
+    m_nBuckets <<= 1;
+  }
+  m_bucketMask = m_nBuckets - 1;
+
+  m_current.slots.assign(m_nBuckets * BUCKET_SIZE, 0);
+  m_previous.slots.assign(m_nBuckets * BUCKET_SIZE, 0);
+}
+
+uint64_t
+PushNonceFilter::makeHash(const Name& name, uint32_t nonce)
+{
+  // the Name of a received Interest is already encoded, hashing its wire needs no allocation
+  const Block& wire = name.wireEncode();
+  size_t seed = boost::hash_range(wire.wire(), wire.wire() + wire.size());
+  boost::hash_combine(seed, nonce);
+
+  // spread the bits, boost::hash_combine leaves the high bits poorly mixed
+  uint64_t hash = static_cast<uint64_t>(seed);
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+bool
+PushNonceFilter::has(const Name& name, uint32_t nonce)
+{
+  this->rotateIfExpired();
+  ++m_nLookups;
+
+  uint64_t hash = makeHash(name, nonce);
+  bool isFound = this->contains(m_current, hash) || this->contains(m_previous, hash);
+  if (isFound) {
+    ++m_nHits;
+  }
+  return isFound;
+}
+
+void
+PushNonceFilter::add(const Name& name, uint32_t nonce)
+{
+  this->rotateIfExpired();
+  ++m_nInserts;
+
+  uint64_t hash = makeHash(name, nonce);
+  if (this->contains(m_current, hash)) {
+    return;
+  }
+
+  if (!this->insert(m_current, hash)) {
+    // current generation is full: forget the oldest entries early
+    ++m_nEarlyRotations;
+    this->rotate();
+    this->insert(m_current, hash);
+  }
+}
+
+void
+PushNonceFilter::rotateIfExpired()
+{
+  time::steady_clock::TimePoint now = time::steady_clock::now();
+  if (now - m_lastRotation < m_lifetime) {
+    return;
+  }
+
+  if (now - m_lastRotation >= 2 * m_lifetime) {
+    // nothing was inserted for two lifetimes, both generations are stale
+    std::fill(m_current.slots.begin(), m_current.slots.end(), 0);
+  }
+  this->rotate();
+  m_lastRotation = now;
+}
+
+void
+PushNonceFilter::rotate()
+{
+  std::swap(m_current, m_previous);
+  std::fill(m_current.slots.begin(), m_current.slots.end(), 0);
+}
+
+static inline uint16_t
+getFingerprint(uint64_t hash)
+{
+  // 0 marks an empty slot
+  uint16_t fingerprint = static_cast<uint16_t>(hash >> 48);
+  return fingerprint == 0 ? 1 : fingerprint;
+}
+
+size_t
+PushNonceFilter::getAltBucket(size_t bucket, Fingerprint fingerprint) const
+{
+  return (bucket ^ (static_cast<size_t>(fingerprint) * 0x5bd1e995)) & m_bucketMask;
+}
+
+bool
+PushNonceFilter::contains(const Generation& generation, uint64_t hash) const
+{
+  Fingerprint fingerprint = getFingerprint(hash);
+  size_t bucket1 = hash & m_bucketMask;
+  size_t bucket2 = this->getAltBucket(bucket1, fingerprint);
+
+  const Fingerprint* slots1 = &generation.slots[bucket1 * BUCKET_SIZE];
+  const Fingerprint* slots2 = &generation.slots[bucket2 * BUCKET_SIZE];
+  for (size_t i = 0; i < BUCKET_SIZE; ++i) {
+    if (slots1[i] == fingerprint || slots2[i] == fingerprint) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+PushNonceFilter::insertIntoBucket(Generation& generation, size_t bucket, Fingerprint fingerprint)
+{
+  Fingerprint* slots = &generation.slots[bucket * BUCKET_SIZE];
+  for (size_t i = 0; i < BUCKET_SIZE; ++i) {
+    if (slots[i] == 0) {
+      slots[i] = fingerprint;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+PushNonceFilter::insert(Generation& generation, uint64_t hash)
+{
+  Fingerprint fingerprint = getFingerprint(hash);
+  size_t bucket = hash & m_bucketMask;
+  if (this->insertIntoBucket(generation, bucket, fingerprint)) {
+    return true;
+  }
+
+  bucket = this->getAltBucket(bucket, fingerprint);
+  if (this->insertIntoBucket(generation, bucket, fingerprint)) {
+    return true;
+  }
+
+  // relocate existing fingerprints to their alternate bucket
+  for (int kick = 0; kick < MAX_KICKS; ++kick) {
+    size_t victim = (m_kickSeed++) % BUCKET_SIZE;
+    std::swap(fingerprint, generation.slots[bucket * BUCKET_SIZE + victim]);
+    bucket = this->getAltBucket(bucket, fingerprint);
+    if (this->insertIntoBucket(generation, bucket, fingerprint)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace nfd
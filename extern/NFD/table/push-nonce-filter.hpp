@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2014-2016,  Regents of the University of California,
+ *                           Arizona Board of Regents,
+ *                           Colorado State University,
+ *                           University Pierre & Marie Curie, Sorbonne University,
+ *                           Washington University in St. Louis,
+ *                           Beijing Institute of Technology,
+ *                           The University of Memphis.
+ *
+ * This file is part of NFD (Named Data Networking Forwarding Daemon).
+ * See AUTHORS.md for complete list of NFD authors and contributors.
+ *
+ * NFD is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NFD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NFD, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NFD_DAEMON_TABLE_PUSH_NONCE_FILTER_HPP
+#define NFD_DAEMON_TABLE_PUSH_NONCE_FILTER_HPP
+
+#include "common.hpp"
+
+namespace nfd {
+
+/** \brief remembers the Nonces of expired Persistent Interests
+ *
+ *  This is the push counterpart of the DeadNonceList. A PI is refreshed with a new Nonce
+ *  every few seconds for the whole duration of a call, the refresh Nonces of a PIT entry
+ *  that is still alive are kept in the entry itself (pit::Entry::addPushNonce). Only the
+ *  Nonces of entries that are finalized end up here.
+ *
+ *  Entries are stored as 16-bit fingerprints in a cuckoo filter with buckets of four
+ *  slots. Two generations of the filter are kept: a Name/Nonce pair is remembered for at
+ *  least one and at most two lifetimes, after which the older generation is cleared.
+ *  As with the DeadNonceList, a false positive only causes a spurious loop detection.
+ */
+class PushNonceFilter : noncopyable
+{
+public:
+  /** \brief constructs the filter
+   *  \param nBuckets number of buckets per generation, rounded up to a power of two
+   *  \param lifetime minimum time an entry is remembered
+   */
+  explicit
+  PushNonceFilter(size_t nBuckets = DEFAULT_N_BUCKETS,
+                  const time::nanoseconds& lifetime = DEFAULT_LIFETIME);
+
+  /** \brief determines if Name+Nonce was inserted during the last one or two lifetimes
+   */
+  bool
+  has(const Name& name, uint32_t nonce);
+
+  /** \brief records Name+Nonce
+   */
+  void
+  add(const Name& name, uint32_t nonce);
+
+  /** \return memory used by both generations in bytes
+   */
+  size_t
+  getMemoryUsage() const
+  {
+    return 2 * m_nBuckets * BUCKET_SIZE * sizeof(Fingerprint);
+  }
+
+  uint64_t
+  getNLookups() const
+  {
+    return m_nLookups;
+  }
+
+  uint64_t
+  getNHits() const
+  {
+    return m_nHits;
+  }
+
+  uint64_t
+  getNInserts() const
+  {
+    return m_nInserts;
+  }
+
+  /** \return number of generations discarded before their lifetime was over
+   *          because no free slot could be found
+   */
+  uint64_t
+  getNEarlyRotations() const
+  {
+    return m_nEarlyRotations;
+  }
+
+public:
+  static const size_t DEFAULT_N_BUCKETS;
+  static const time::nanoseconds DEFAULT_LIFETIME;
+
+private:
+  typedef uint16_t Fingerprint;
+  static const size_t BUCKET_SIZE = 4;
+  static const int MAX_KICKS = 128;
+
+  struct Generation
+  {
+    std::vector<Fingerprint> slots;
+  };
+
+  static uint64_t
+  makeHash(const Name& name, uint32_t nonce);
+
+  void
+  rotateIfExpired();
+
+  void
+  rotate();
+
+  bool
+  contains(const Generation& generation, uint64_t hash) const;
+
+  bool
+  insert(Generation& generation, uint64_t hash);
+
+  bool
+  insertIntoBucket(Generation& generation, size_t bucket, Fingerprint fingerprint);
+
+  size_t
+  getAltBucket(size_t bucket, Fingerprint fingerprint) const;
+
+private:
+  size_t m_nBuckets;
+  size_t m_bucketMask;
+  time::nanoseconds m_lifetime;
+
+  Generation m_current;
+  Generation m_previous;
+  time::steady_clock::TimePoint m_lastRotation;
+  uint32_t m_kickSeed;
+
+  uint64_t m_nLookups;
+  uint64_t m_nHits;
+  uint64_t m_nInserts;
+  uint64_t m_nEarlyRotations;
+};
+
+} // namespace nfd
+
+#endif // NFD_DAEMON_TABLE_PUSH_NONCE_FILTER_HPP
@@ -62,10 +62,21 @@ NackHeader::NackHeader(const Block& block)
   wireDecode(block);
 }
 
+NackHeader::NackHeader(NackReason reason)
+{
+  setReason(reason);
+}
+
 template<encoding::Tag TAG>
 size_t
 NackHeader::wireEncode(EncodingImpl<TAG>& encoder) const
 {
+  // lp::Packet::add<NackField> encodes the header through this overload
+  const Block& precomputed = getPrecomputedWire(m_reason);
+  if (precomputed.hasWire()) {
+    return encoder.prependBlock(precomputed);
+  }
+
   size_t length = 0;
   length += prependNonNegativeIntegerBlock(encoder, tlv::NackReason,
                                            static_cast<uint32_t>(m_reason));
@@ -87,6 +98,12 @@ NackHeader::wireEncode() const
     return m_wire;
   }
 
+  const Block& precomputed = getPrecomputedWire(m_reason);
+  if (precomputed.hasWire()) {
+    m_wire = precomputed;
+    return m_wire;
+  }
+
   EncodingEstimator estimator;
   size_t estimatedSize = wireEncode(estimator);
 
@@ -121,6 +138,43 @@ NackHeader::wireDecode(const Block& wire)
   }
 }
 
+static Block
+makeNackHeaderWire(NackReason reason)
+{
+  EncodingBuffer encoder;
+  size_t length = prependNonNegativeIntegerBlock(encoder, tlv::NackReason,
+                                                 static_cast<uint32_t>(reason));
+  encoder.prependVarNumber(length);
+  encoder.prependVarNumber(tlv::Nack);
+  return encoder.block();
+}
+
+const Block&
+NackHeader::getPrecomputedWire(NackReason reason)
+{
+  static const Block none;
+  static const Block congestion = makeNackHeaderWire(NackReason::CONGESTION);
+  static const Block duplicate = makeNackHeaderWire(NackReason::DUPLICATE);
+  static const Block noRoute = makeNackHeaderWire(NackReason::NO_ROUTE);
+  static const Block tainted = makeNackHeaderWire(NackReason::TAINTED);
+  static const Block piTeardown = makeNackHeaderWire(NackReason::PI_TEARDOWN);
+
+  switch (reason) {
+  case NackReason::CONGESTION:
+    return congestion;
+  case NackReason::DUPLICATE:
+    return duplicate;
+  case NackReason::NO_ROUTE:
+    return noRoute;
+  case NackReason::TAINTED:
+    return tainted;
+  case NackReason::PI_TEARDOWN:
+    return piTeardown;
+  default:
+    return none;
+  }
+}
+
 NackReason
 NackHeader::getReason() const
 {
@@ -140,7 +194,7 @@ NackHeader&
 NackHeader::setReason(NackReason reason)
 {
   m_reason = reason;
-  m_wire.reset();
+  m_wire = getPrecomputedWire(reason);
   return *this;
 }
 
@@ -59,6 +59,14 @@ public:
   explicit
   NackHeader(const Block& block);
 
+  /** \brief create a header with the given reason
+   *
+   *  The wire encoding of the known reasons is built once and shared by all headers,
+   *  so creating and encoding such a header does not allocate.
+   */
+  explicit
+  NackHeader(NackReason reason);
+
   template<encoding::Tag TAG>
   size_t
   wireEncode(EncodingImpl<TAG>& encoder) const;
@@ -84,6 +92,13 @@ public: // reason
   NackHeader&
   setReason(NackReason reason);
 
+private:
+  /** \return shared wire encoding of a header with \p reason,
+   *          or an empty block if \p reason is not a known reason
+   */
+  static const Block&
+  getPrecomputedWire(NackReason reason);
+
 private:
   NackReason m_reason;
   mutable Block m_wire;
@@ -3,8 +3,14 @@
 
 from subprocess import call
 from sys import argv
+from collections import OrderedDict
+import itertools
+import json
 import os
+import shutil
 import subprocess
+import threading
+import time
 import workerpool
 import multiprocessing
 import argparse
@@ -26,6 +32,19 @@ parser.add_argument('-s', '--simulate', dest="simulate", action='store_true', de
 parser.add_argument('-g', '--no-graph', dest="graph", action='store_false', default=True,
                     help='Do not build a graph for the scenario (builds a graph by default)')
 
+parser.add_argument('-j', '--jobs', dest="jobs", type=int, default=multiprocessing.cpu_count(),
+                    help='Maximum number of simulations running at the same time (number of cores by default)')
+
+parser.add_argument('-m', '--mem-per-run', dest="memPerRun", type=int, default=1024,
+                    help='Expected peak memory of one simulation in MB, raised to the largest peak seen so far '
+                    '(1024 by default). A simulation is only started if that much memory is available')
+
+parser.add_argument('-r', '--results', dest="results", type=str, default="results",
+                    help='Directory of the result shards (results by default)')
+
+parser.add_argument('--no-snapshots', dest="snapshots", action='store_false', default=True,
+                    help='Generate the topology in every run instead of sharing snapshots and routes')
+
 args = parser.parse_args()
 
 if not args.list and len(args.scenarios)==0:
@@ -46,6 +65,70 @@ else:
 ######################################################################
 ######################################################################
 
+def writeJson (fileName, content):
+    "Replaces fileName atomically, an interrupted runner never leaves half a manifest"
+    tmpName = fileName + ".tmp"
+    with open (tmpName, "w") as f:
+        json.dump (content, f, indent=2, sort_keys=True)
+    os.rename (tmpName, fileName)
+
+def readJson (fileName):
+    try:
+        with open (fileName) as f:
+            return json.load (f)
+    except (IOError, ValueError):
+        return None
+
+class MemoryAdmission:
+    """Starts a simulation only if the memory it is expected to need is available
+
+    Running simulations that have not yet reached the expected peak still reserve the
+    difference, MemAvailable of /proc/meminfo only contains what they use right now.
+    The expectation is raised to the largest peak RSS of any finished simulation.
+    """
+    def __init__ (self, memPerRun):
+        self.expected = memPerRun * 1024 * 1024
+        self.running = {}
+        self.condition = threading.Condition ()
+
+    def available (self):
+        with open ("/proc/meminfo") as f:
+            for line in f:
+                if line.startswith ("MemAvailable:"):
+                    return int (line.split ()[1]) * 1024
+        return float ("inf")
+
+    def rss (self, pid):
+        try:
+            with open ("/proc/%d/statm" % pid) as f:
+                return int (f.read ().split ()[1]) * os.sysconf ("SC_PAGE_SIZE")
+        except (IOError, ValueError):
+            return 0
+
+    def reserved (self):
+        reserved = 0
+        for pid in self.running.values ():
+            reserved += self.expected if pid is None else max (0, self.expected - self.rss (pid))
+        return reserved
+
+    def acquire (self, job):
+        with self.condition:
+            while self.running and self.available () - self.reserved () < self.expected:
+                self.condition.wait (5.0)
+            self.running[job] = None
+
+    def started (self, job, pid):
+        with self.condition:
+            self.running[job] = pid
+
+    def release (self, job, maxRss):
+        with self.condition:
+            del self.running[job]
+            self.expected = max (self.expected, maxRss)
+            self.condition.notify_all ()
+
+admission = MemoryAdmission (args.memPerRun)
+
 class SimulationJob (workerpool.Job):
     "Job to simulate things"
     def __init__ (self, cmdline):
@@ -54,7 +137,63 @@ class SimulationJob (workerpool.Job):
         print (" ".join (self.cmdline))
         subprocess.call (self.cmdline)
 
-pool = workerpool.WorkerPool(size = multiprocessing.cpu_count())
+class ShardJob (workerpool.Job):
+    """Job that runs one point of a sweep in its own result shard
+
+    The simulation runs inside the shard directory (BRITE writes its seed files to the
+    working directory) and writes its logs and stdout there. manifest.json records the
+    parameters, the command line and the outcome; a shard is complete once the manifest
+    says so.
+    """
+    def __init__ (self, sweep, shard, parameters):
+        self.sweep = sweep
+        self.shard = shard
+        self.parameters = parameters
+
+    def run (self):
+        admission.acquire (self)
+
+        if os.path.exists (self.shard):
+            shutil.rmtree (self.shard)
+        os.makedirs (self.shard)
+
+        snapshot = self.sweep.claimSnapshot (self.parameters)
+        cmdline = self.sweep.cmdline (self.shard, self.parameters, snapshot)
+        manifest = {
+            "scenario": self.sweep.name,
+            "parameters": self.parameters,
+            "cmdline": cmdline,
+            "status": "running",
+            "started": time.strftime ("%Y-%m-%dT%H:%M:%S"),
+            }
+        manifestName = os.path.join (self.shard, "manifest.json")
+        writeJson (manifestName, manifest)
+
+        print (" ".join (cmdline))
+        start = time.time ()
+        with open (os.path.join (self.shard, "stdout.txt"), "w") as output:
+            process = subprocess.Popen (cmdline, cwd=self.shard, stdout=output, stderr=subprocess.STDOUT)
+            admission.started (self, process.pid)
+            # wait4 instead of wait for the peak memory of this simulation alone
+            pid, status, usage = os.wait4 (process.pid, 0)
+        maxRss = usage.ru_maxrss * 1024
+        returncode = -(status & 0x7f) if os.WIFSIGNALED (status) else os.WEXITSTATUS (status)
+        admission.release (self, maxRss)
+
+        self.sweep.releaseSnapshot (snapshot, returncode == 0)
+
+        manifest.update ({
+            "status": "complete" if returncode == 0 else "failed",
+            "returncode": returncode,
+            "finished": time.strftime ("%Y-%m-%dT%H:%M:%S"),
+            "wallTime": round (time.time () - start, 3),
+            "maxRss": maxRss,
+            })
+        writeJson (manifestName, manifest)
+        if returncode != 0:
+            print ("FAILED (%d): %s" % (returncode, self.shard))
+
+pool = workerpool.WorkerPool(size = args.jobs)
 
 class Processor:
     def run (self):
@@ -92,9 +231,152 @@ class Scenario (Processor):
         # any postprocessing, if any
         pass
 
+class Sweep (Processor):
+    """Runs a scenario for every point of a parameter grid
+
+    grid maps command line options of the scenario to their values, the cross product
+    of all of them is simulated, one result shard per point:
+
+        <results>/<name>/<option>=<value>_..._seed=<seed>/
+
+    seeds are passed as --RngRun, fixed options are the same for every point. Shards
+    whose manifest is complete are skipped, so an interrupted sweep continues where it
+    stopped when it is started again.
+
+    Runs that only differ in options not listed in snapshotKey share one topology
+    snapshot (--topologySnapshot), generated by the first of them; all runs share the
+    route cache (--routeCache).
+    """
+    def __init__ (self, name, program, grid, seeds, fixed = {}, snapshotKey = []):
+        self.name = name
+        self.program = os.path.abspath (os.path.join ("build", program))
+        self.grid = grid
+        self.seeds = seeds
+        self.fixed = fixed
+        self.snapshotKey = snapshotKey
+        self.directory = os.path.abspath (os.path.join (args.results, name))
+        self.snapshotLock = threading.Lock ()
+        self.snapshotsInProgress = set ()
+
+    def points (self):
+        names = self.grid.keys ()
+        for values in itertools.product (*[self.grid[name] for name in names]):
+            for seed in self.seeds:
+                parameters = OrderedDict (zip (names, [str (value) for value in values]))
+                parameters["seed"] = str (seed)
+                yield parameters
+
+    def shardName (self, parameters):
+        return "_".join ("%s=%s" % (name, value) for name, value in parameters.items ()).replace ("/", "-")
+
+    def shard (self, parameters):
+        return os.path.join (self.directory, self.shardName (parameters))
+
+    def isComplete (self, shard):
+        manifest = readJson (os.path.join (shard, "manifest.json"))
+        return manifest is not None and manifest.get ("status") == "complete"
+
+    def claimSnapshot (self, parameters):
+        """Snapshot file to pass to a run, None if the run has to generate its own topology
+
+        Only one run per snapshot writes it; the others generate the same topology themselves
+        until it is finished. A snapshot counts as finished once its writer exited successfully.
+        """
+        if not args.snapshots or not self.snapshotKey:
+            return None
+
+        snapshot = os.path.join (self.directory, "snapshots",
+                                 self.shardName (OrderedDict ((key, parameters[key]) for key in self.snapshotKey)) + ".topo")
+        with self.snapshotLock:
+            if os.path.exists (snapshot + ".done"):
+                return snapshot
+            if snapshot in self.snapshotsInProgress:
+                return None
+            self.snapshotsInProgress.add (snapshot)
+
+        # left over by an interrupted writer
+        if os.path.exists (snapshot):
+            os.remove (snapshot)
+        return snapshot
+
+    def releaseSnapshot (self, snapshot, isSuccessful):
+        if snapshot is None:
+            return
+        with self.snapshotLock:
+            if snapshot in self.snapshotsInProgress:
+                self.snapshotsInProgress.remove (snapshot)
+                if isSuccessful and os.path.exists (snapshot):
+                    open (snapshot + ".done", "w").close ()
+
+    def cmdline (self, shard, parameters, snapshot):
+        cmdline = [self.program, "--logDir=%s/" % shard]
+        for name, value in self.fixed.items ():
+            cmdline.append ("--%s=%s" % (name, value))
+        for name, value in parameters.items ():
+            if name == "seed":
+                cmdline.append ("--RngRun=%s" % value)
+            else:
+                cmdline.append ("--%s=%s" % (name, value))
+        if snapshot is not None:
+            cmdline.append ("--topologySnapshot=%s" % snapshot)
+        if args.snapshots:
+            cmdline.append ("--routeCache=%s" % os.path.join (self.directory, "routes"))
+        return cmdline
+
+    def simulate (self):
+        if args.snapshots:
+            for directory in ["snapshots", "routes"]:
+                if not os.path.isdir (os.path.join (self.directory, directory)):
+                    os.makedirs (os.path.join (self.directory, directory))
+
+        total = 0
+        skipped = 0
+        for parameters in self.points ():
+            total += 1
+            shard = self.shard (parameters)
+            if self.isComplete (shard):
+                skipped += 1
+                continue
+            pool.put (ShardJob (self, shard, parameters))
+        print "%s: %d runs, %d already complete" % (self.name, total, skipped)
+
+    def postprocess (self):
+        "Writes the manifest of the sweep, listing every shard and its status"
+        shards = []
+        for parameters in self.points ():
+            shard = self.shard (parameters)
+            manifest = readJson (os.path.join (shard, "manifest.json"))
+            shards.append ({
+                "shard": os.path.relpath (shard, self.directory),
+                "parameters": parameters,
+                "status": manifest.get ("status") if manifest else "missing",
+                })
+        writeJson (os.path.join (self.directory, "manifest.json"), {
+            "scenario": self.name,
+            "program": self.program,
+            "grid": self.grid,
+            "seeds": self.seeds,
+            "fixed": self.fixed,
+            "shards": shards,
+            })
+        failed = [s["shard"] for s in shards if s["status"] != "complete"]
+        print "%s: %d of %d runs complete" % (self.name, len (shards) - len (failed), len (shards))
+        for shard in failed:
+            print "    incomplete: " + shard
+
 try:
     # Simulation, processing, and graph building
-    fig = Scenario (name="NAME_TO_CONFIGURE")
+    fig = Sweep (name="bitvector-length", program="bitvector-length",
+                 grid=OrderedDict ([
+                     ("bitvectorLength", [0, 4, 8, 16, 32]),
+                     ("piRefreshFrequency", ["0.5s", "1.5s", "3s"]),
+                     ("linkErrors", [0, 5, 10]),
+                     ("calls", [20, 100]),
+                     ]),
+                 seeds=range (1, 6),
+                 fixed={"approach": "push",
+                        "briteConfig": os.path.abspath ("brite_configs/brite_medium_bw.conf")},
+                 snapshotKey=["linkErrors", "calls", "seed"])
     fig.run ()
 
 finally:
@@ -26,13 +26,28 @@
 //#include "ns3/ndnSIM/utils/tracers/ndn-l3-packet-tracer.hpp"
 
 #include "../extensions/randnetworks/networkgenerator.h"
+#include "../extensions/apps/flow-statistics.hpp"
+#include "../extensions/apps/fixedjitterbuffer.h"
 
 #include "../extensions/utils/parameterconfiguration.h"
+#include "../extensions/utils/parallel-routing-helper.hpp"
+#include "../extensions/utils/mpi-partition.hpp"
+#include "../extensions/utils/replications.hpp"
 #include "../extensions/strategies/lowest-cost-strategy.hpp"
 
 #include "../extensions/tracers/push-tracer.hpp"
 #include "../extensions/tracers/ndn-l3-packet-tracer.hpp"
+#include "../extensions/tracers/columnar-writer.hpp"
+#include "../extensions/tracers/forwarder-counters-tracer.hpp"
+#include "../extensions/tracers/trace-filter.hpp"
+#include "../extensions/tracers/trace-sink.hpp"
 
+#include "fw/forwarder.hpp"
+#include "fw/push-nonce-memory.hpp"
+#include "fw/push-counters.hpp"
+
+#include <fstream>
+#include <memory>
 #include <sstream>
 
 namespace ns3 {
@@ -52,6 +67,126 @@ saveCallInfo(std::string fname, std::vector<std::string> callVector)
   file.close();
 }
 
+/**
+ * Prints size and lookup cost of the Dead Nonce Lists and push Nonce filters of all nodes
+ */
+void
+printNonceMemory(const NodeContainer& nodes)
+{
+  size_t dnlEntries = 0;
+  uint64_t dnlLookups = 0;
+  uint64_t dnlLookupNanoseconds = 0;
+  uint64_t dnlInserts = 0;
+  uint64_t dnlInsertsSkipped = 0;
+  size_t filterMemory = 0;
+  uint64_t filterLookups = 0;
+  uint64_t filterHits = 0;
+  uint64_t ringHits = 0;
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); ++node) {
+    Ptr<ndn::L3Protocol> l3 = (*node)->GetObject<ndn::L3Protocol>();
+    if (l3 == nullptr) {
+      continue;
+    }
+    nfd::Forwarder& forwarder = *l3->getForwarder();
+    const nfd::fw::PushNonceMemory& memory = forwarder.getPushNonceMemory();
+    dnlEntries += forwarder.getDeadNonceList().size();
+    dnlLookups += memory.nDnlLookups;
+    dnlLookupNanoseconds += memory.dnlLookupNanoseconds;
+    dnlInserts += memory.nDnlInserts;
+    dnlInsertsSkipped += memory.nDnlInsertsSkipped;
+    filterMemory += memory.filter.getMemoryUsage();
+    filterLookups += memory.filter.getNLookups();
+    filterHits += memory.filter.getNHits();
+    ringHits += memory.nRingHits;
+  }
+
+  std::cout << "DNL entries: " << dnlEntries << " (~"
+            << nfd::fw::PushNonceMemory::estimateDnlMemoryUsage(dnlEntries) / 1024 << " KiB)" << std::endl;
+  std::cout << "DNL inserts: " << dnlInserts << " skipped for push: " << dnlInsertsSkipped << std::endl;
+  std::cout << "DNL lookups: " << dnlLookups;
+  if (dnlLookupNanoseconds > 0) {
+    std::cout << " avg " << dnlLookupNanoseconds / dnlLookups << " ns";
+  }
+  std::cout << std::endl;
+  std::cout << "Push nonce filter: " << filterMemory / 1024 << " KiB, lookups: " << filterLookups
+            << " hits: " << filterHits << " ring hits: " << ringHits << std::endl;
+}
+
+/**
+ * Prints the loop prevention counters of the forwarders of all nodes
+ */
+void
+printPushCounters(const NodeContainer& nodes)
+{
+  uint64_t loopingDrops = 0;
+  uint64_t windowMisses = 0;
+  uint64_t duplicateDeliveries = 0;
+  uint64_t forwardedRefreshes = 0;
+  uint64_t coalescedRefreshes = 0;
+  std::map<ndn::Name, uint64_t> duplicatesByPrefix;
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); ++node) {
+    Ptr<ndn::L3Protocol> l3 = (*node)->GetObject<ndn::L3Protocol>();
+    if (l3 == nullptr) {
+      continue;
+    }
+    const nfd::fw::PushCounters& counters = l3->getForwarder()->getPushCounters();
+    loopingDrops += counters.nLoopingDrops;
+    windowMisses += counters.nBitvectorWindowMisses;
+    duplicateDeliveries += counters.nDuplicateDeliveries;
+    forwardedRefreshes += counters.nForwardedRefreshes;
+    coalescedRefreshes += counters.nCoalescedRefreshes;
+    for (const auto& prefix : counters.duplicateDeliveriesByPrefix) {
+      duplicatesByPrefix[prefix.first] += prefix.second;
+    }
+  }
+
+  std::cout << "Looping push Data dropped: " << loopingDrops << std::endl;
+  std::cout << "Push Data outside of the bitvector window: " << windowMisses << std::endl;
+  std::cout << "Duplicate push Data deliveries: " << duplicateDeliveries << std::endl;
+  for (const auto& prefix : duplicatesByPrefix) {
+    std::cout << "  " << prefix.first << ": " << prefix.second << std::endl;
+  }
+  std::cout << "Forwarded PI refreshes: " << forwardedRefreshes << std::endl;
+  std::cout << "Coalesced PI refreshes: " << coalescedRefreshes << std::endl;
+}
+
+/**
+ * Writes one line per node and sample of the ForwarderCountersTracer
+ */
+void
+writeForwarderCounters(std::ofstream* os, Time time, const ndn::ForwarderCountersTracer::Sample& sample)
+{
+  *os << time.ToDouble(Time::S) << "\t" << sample.nodeId << "\t"
+      << sample.nInInterests << "\t" << sample.nOutInterests << "\t"
+      << sample.nInData << "\t" << sample.nOutData << "\t"
+      << sample.nLoopingDrops << "\t" << sample.nBitvectorWindowMisses << "\t"
+      << sample.nDuplicateDeliveries << "\n";
+}
+
+/**
+ * Installs an L2RateTracer writing to @p sink on every node of this MPI rank
+ */
+std::list<Ptr<L2RateTracer>>
+installL2RateTracers(std::shared_ptr<ndn::TraceSink> sink, Time period)
+{
+  std::list<Ptr<L2RateTracer>> tracers;
+  std::shared_ptr<std::ostream> os = sink->getStream();
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); ++node) {
+    if (!ndn::MpiPartition::IsLocal(*node)) {
+      continue;
+    }
+    Ptr<L2RateTracer> tracer = Create<L2RateTracer>(os, *node);
+    tracer->SetAveragingPeriod(period);
+    tracers.push_back(tracer);
+  }
+
+  if (!tracers.empty()) {
+    tracers.front()->PrintHeader(*os);
+    *os << "\n";
+  }
+  return tracers;
+}
+
 
 int
 main(int argc, char* argv[])
@@ -66,8 +201,25 @@ main(int argc, char* argv[])
   std::string piRefreshFrequency = "1.5s";
   std::string linkErrorParam = "0";
   std::string skipLogging = "false";
+  std::string topologySnapshot = "";
+  std::string routeCache = "";
+  std::string failureSchedule = "";
   std::string numCalls = "20";
   std::string bitvectorLength = "0";
+  double piRefreshCoalescing = 0.0;
+  bool pushSkipDnl = false;
+  bool timeDnlLookups = false;
+  bool binaryTrace = false;
+  bool aggregatePushTrace = false;
+  bool columnarTraces = false;
+  std::string traceFilter = "";
+  std::string asyncTraces = "off";
+  bool flowStats = false;
+  std::string jitterBuffer = "0ms";
+  bool adaptiveJitterBuffer = false;
+  bool mpi = false;
+  uint32_t replications = 1;
+  uint32_t replicationJobs = 0;
 
   // Read Commandline Parameters
   CommandLine cmd;
@@ -80,15 +232,53 @@ main(int argc, char* argv[])
   cmd.AddValue("linkErrors", "Number of link errors during simulation", linkErrorParam);
   cmd.AddValue("calls", "Number of simulated telephone calls", numCalls);
   cmd.AddValue("bitvectorLength", "Length of the bitvector for loop detection", bitvectorLength);
+  cmd.AddValue("piRefreshCoalescing", "Fraction of the PI lifetime within which refreshes are coalesced (0=off)", piRefreshCoalescing);
+  cmd.AddValue("pushSkipDnl", "Keep Nonces of Persistent Interests out of the Dead Nonce List", pushSkipDnl);
+  cmd.AddValue("timeDnlLookups", "Measure the wall clock time of Dead Nonce List lookups", timeDnlLookups);
+  cmd.AddValue("binaryTrace", "Write the packet trace in binary format (see convert-trace.py)", binaryTrace);
+  cmd.AddValue("aggregatePushTrace", "Write one summary line per node, prefix and second to the push trace", aggregatePushTrace);
+  cmd.AddValue("columnarTraces", "Write call info, link failures and packet traces in columnar format (.col)", columnarTraces);
+  cmd.AddValue("traceFilter", "Packets to trace, e.g. \"prefix=/voip;type=InData;node=core;sample=100\" "
+               "(node sets: core, leaf, Callee, Client, DataServer, DataClient)", traceFilter);
+  cmd.AddValue("asyncTraces", "Write push, packet and drop traces from a background thread (off|block|drop)", asyncTraces);
+  cmd.AddValue("flowStats", "Measure latency and jitter of every push flow, written to flow-stats.txt", flowStats);
+  cmd.AddValue("jitterBuffer", "Playout delay of the receivers' jitter buffers, playout statistics are written to playout-stats.txt (0ms=off)", jitterBuffer);
+  cmd.AddValue("adaptiveJitterBuffer", "Adapt the playout delay to the measured jitter", adaptiveJitterBuffer);
   cmd.AddValue("skipLogging", "No logging when parameter is true", skipLogging);
+  cmd.AddValue("topologySnapshot", "Load topology, placed nodes and link failures from this snapshot if it exists, "
+               "otherwise generate them and save them there. A loaded snapshot keeps its link failures, "
+               "linkErrors and failureSchedule are then ignored", topologySnapshot);
+  cmd.AddValue("routeCache", "Directory where the calculated routes are cached per topology", routeCache);
+  cmd.AddValue("failureSchedule", "Add the link failures of the failure processes in this file (times in ms)",
+               failureSchedule);
+  cmd.AddValue("mpi", "Distribute the ASs over the MPI ranks (set by ./waf --mpi=<ranks>)", mpi);
+  cmd.AddValue("replications", "Fork this many replications with the runs RngRun, RngRun+1, ... after building "
+               "the topology, each writes to <logDir>run-<run>/", replications);
+  cmd.AddValue("replicationJobs", "Replications running at the same time (0=number of cores)", replicationJobs);
   cmd.Parse(argc, argv);
 
+  if (mpi) {
+    ndn::MpiPartition::Enable(&argc, &argv);
+  }
+  uint32_t systemCount = ndn::MpiPartition::GetSize();
+  bool isMainRank = ndn::MpiPartition::GetRank() == 0;
+  // every rank writes the traces of its own nodes
+  auto logFile = [&logDir] (const std::string& file) {
+    return ndn::MpiPartition::GetLocalFileName(logDir + file);
+  };
+
   if (!(approach.compare("push") == 0 || 
         approach.compare("prerequest") == 0 || 
         approach.compare("standard") == 0)) {
     std::cout << "Invalid Approach parameter: " << approach << std::endl;
     exit(-1);
   }
+  // the send times of the flow statistics are looked up in memory, producer and consumer
+  // have to run in the same process
+  if (systemCount > 1 && (flowStats || !Time(jitterBuffer).IsZero())) {
+    std::cout << "flowStats and jitterBuffer are not supported with more than one MPI rank" << std::endl;
+    exit(-1);
+  }
   int linkErrors = std::stoi(linkErrorParam);
 
   std::cout << "Parameters" << std::endl;
@@ -100,12 +290,33 @@ main(int argc, char* argv[])
   std::cout << "Link errors: " << linkErrors << std::endl;
   std::cout << "Phone calls: " << numCalls << std::endl;
   std::cout << "Bitvector length: " << bitvectorLength << std::endl;
+  std::cout << "PI refresh coalescing: " << piRefreshCoalescing << std::endl;
+  std::cout << "Push skips DNL: " << pushSkipDnl << std::endl;
+  if (systemCount > 1) {
+    std::cout << "MPI rank: " << ndn::MpiPartition::GetRank() << " of " << systemCount << std::endl;
+  }
   std::cout << std::endl;
 
   ParameterConfiguration::getInstance()->setParameter("bitector_length", std::stoi(bitvectorLength));
-
-  // 1) Parse Brite-Config and generate network with BRITE
-  ns3::ndn::NetworkGenerator gen(confFile, queue, 50);
+  ParameterConfiguration::getInstance()->setParameter("PI_REFRESH_COALESCING", piRefreshCoalescing);
+  ParameterConfiguration::getInstance()->setParameter("PUSH_SKIP_DNL", pushSkipDnl ? 1 : 0);
+  ParameterConfiguration::getInstance()->setParameter("TIME_DNL_LOOKUPS", timeDnlLookups ? 1 : 0);
+
+  // 1) Parse Brite-Config and generate network with BRITE, or load a previously generated one
+  bool isSnapshotLoaded = !topologySnapshot.empty() && std::ifstream(topologySnapshot.c_str()).good();
+  std::unique_ptr<ns3::ndn::NetworkGenerator> generator;
+  if (isSnapshotLoaded) {
+    std::cout << "Loading topology snapshot " << topologySnapshot << std::endl;
+    if (linkErrors != 0 || !failureSchedule.empty()) {
+      std::cout << "Warning: linkErrors and failureSchedule are ignored, the link failures of the "
+                << "snapshot are used" << std::endl;
+    }
+    generator.reset(ns3::ndn::NetworkGenerator::fromSnapshot(topologySnapshot, systemCount));
+  }
+  else {
+    generator.reset(new ns3::ndn::NetworkGenerator(confFile, queue, 50, systemCount));
+  }
+  ns3::ndn::NetworkGenerator& gen = *generator;
 
   uint32_t simTime = 10 * 60* 1000; // Simtime in milliseconds (10 minutes)
   uint32_t avgCallDuration = 150000; // http://www.bundesnetzagentur.de/SharedDocs/Pressemitteilungen/DE/2011/110728DauerHandygespraeche.html
@@ -117,39 +328,41 @@ main(int argc, char* argv[])
   int additional_random_connections_as = -1;
   int additional_random_connections_leaf = - 1;
 
-  // Config for Medium connectivity from example.cc
-  min_bw_as = 3000;
-  max_bw_as = 5000;
+  if (!isSnapshotLoaded) {
+    // Config for Medium connectivity from example.cc
+    min_bw_as = 3000;
+    max_bw_as = 5000;
 
-  min_bw_leaf = 500;
-  max_bw_leaf = 1500;
+    min_bw_leaf = 500;
+    max_bw_leaf = 1500;
 
-  //
-  additional_random_connections_as = gen.getNumberOfAS ();
-  additional_random_connections_leaf = gen.getAllASNodesFromAS (0).size () / 2;
+    //
+    additional_random_connections_as = gen.getNumberOfAS ();
+    additional_random_connections_leaf = gen.getAllASNodesFromAS (0).size () / 2;
 
-  // Add random connections between nodes
-  gen.randomlyAddConnectionsBetweenTwoAS (additional_random_connections_as,min_bw_as,max_bw_as,5,20);
-  gen.randomlyAddConnectionsBetweenTwoNodesPerAS(additional_random_connections_leaf,min_bw_leaf,max_bw_leaf,5,20);
+    // Add random connections between nodes
+    gen.randomlyAddConnectionsBetweenTwoAS (additional_random_connections_as,min_bw_as,max_bw_as,5,20);
+    gen.randomlyAddConnectionsBetweenTwoNodesPerAS(additional_random_connections_leaf,min_bw_leaf,max_bw_leaf,5,20);
 
-  //NodeContainer routers = gen.getAllASNodes ();
-  //ns3::ndn::CsTracer::Install(routers, std::string(outputFolder + "/cs-trace.txt"), Seconds(1.0));
+    //NodeContainer routers = gen.getAllASNodes ();
+    //ns3::ndn::CsTracer::Install(routers, std::string(outputFolder + "/cs-trace.txt"), Seconds(1.0));
 
 
-  // 2) Create Callees, Callers, and cross-traffic clients/server
-  PointToPointHelper *p2p = new PointToPointHelper;
-  p2p->SetChannelAttribute ("Delay", StringValue ("2ms"));
+    // 2) Create Callees, Callers, and cross-traffic clients/server
+    PointToPointHelper *p2p = new PointToPointHelper;
+    p2p->SetChannelAttribute ("Delay", StringValue ("2ms"));
 
-  p2p->SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
-  gen.randomlyPlaceNodes (std::stoi(numCalls), "Callee",ns3::ndn::NetworkGenerator::LeafNode, p2p);
+    p2p->SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+    gen.randomlyPlaceNodes (std::stoi(numCalls), "Callee",ns3::ndn::NetworkGenerator::LeafNode, p2p);
 
-  p2p->SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
-  gen.randomlyPlaceNodes (std::stoi(numCalls), "Client",ns3::ndn::NetworkGenerator::LeafNode, p2p);
+    p2p->SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+    gen.randomlyPlaceNodes (std::stoi(numCalls), "Client",ns3::ndn::NetworkGenerator::LeafNode, p2p);
 
-  p2p->SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
-  gen.randomlyPlaceNodes (4, "DataServer",ns3::ndn::NetworkGenerator::LeafNode, p2p);
-  p2p->SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
-  gen.randomlyPlaceNodes (4, "DataClient",ns3::ndn::NetworkGenerator::LeafNode, p2p);
+    p2p->SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+    gen.randomlyPlaceNodes (4, "DataServer",ns3::ndn::NetworkGenerator::LeafNode, p2p);
+    p2p->SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+    gen.randomlyPlaceNodes (4, "DataClient",ns3::ndn::NetworkGenerator::LeafNode, p2p);
+  }
 
 
   // 3) Install NDN Stack on all nodes
@@ -171,6 +384,35 @@ main(int argc, char* argv[])
   ns3::ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
   ndnGlobalRoutingHelper.InstallAll ();
 
+  // the prefixes only depend on the placed nodes, not on the calls
+  for (uint i = 0; i < client.size(); i++) {
+    Ptr<Node> caller = Names::Find<Node>(std::string("Client_" + boost::lexical_cast<std::string>(i)));
+    Ptr<Node> callee = server.Get(i);
+    ndnGlobalRoutingHelper.AddOrigins("/voip/" + boost::lexical_cast<std::string>(caller->GetId()), caller);
+    ndnGlobalRoutingHelper.AddOrigins("/voip/" + boost::lexical_cast<std::string>(callee->GetId()), callee);
+  }
+  for (uint i = 0; i < dataServer.size(); i++) {
+    Ptr<Node> server = dataServer.Get(i);
+    ndnGlobalRoutingHelper.AddOrigins("/data/" + boost::lexical_cast<std::string>(server->GetId()), server);
+  }
+
+  // Calculate and install FIBs
+  //ndn::GlobalRoutingHelper::CalculateRoutes();
+  ns3::ndn::ParallelRoutingHelper::CalculateAllPossibleRoutes (routeCache);
+
+  if (!isSnapshotLoaded) {
+    for(int i = 0; i < linkErrors; i++)
+      gen.creatRandomLinkFailure(0, simTime, 2250, 2250);
+    if (!failureSchedule.empty())
+      gen.loadLinkFailureSchedule(failureSchedule);
+  }
+  if (!topologySnapshot.empty() && !isSnapshotLoaded && isMainRank) {
+    gen.exportSnapshot(topologySnapshot);
+  }
+
+  // everything above is shared by the replications, the calls below are drawn by each of them
+  logDir = ndn::Replications::Fork(replications, replicationJobs, logDir);
+
   Ptr<UniformRandomVariable> arrivalDistribution = CreateObject<UniformRandomVariable>();
   Ptr<UniformRandomVariable> calleeDistribution = CreateObject<UniformRandomVariable>();
   Ptr<NormalRandomVariable> durationDistribution = CreateObject<NormalRandomVariable>();
@@ -196,12 +438,24 @@ main(int argc, char* argv[])
     callLog.push_back(callInfo.str());
     // std::cout << "Call from node " << caller->GetId() << " to " << callee->GetId() << " starts at " << arrival << " (length=" << callLengths[i] << ")" << std::endl;
   }
-  saveCallInfo(logDir + "callInfo.csv", callLog);
+  // the calls and link failures are the same on every rank
+  if (isMainRank) {
+    if (columnarTraces) {
+      ndn::ColumnarWriter::writeTable(logDir + "callInfo.col", {"Caller", "Callee", "startTime", "endTime"}, callLog);
+    }
+    else {
+      saveCallInfo(logDir + "callInfo.csv", callLog);
+    }
+  }
 
-  for(int i = 0; i < linkErrors; i++)
-    gen.creatRandomLinkFailure(0, simTime, 2250, 2250);
-  gen.exportLinkFailures(logDir + "link-failures.csv");
-  
+  if (isMainRank) {
+    if (columnarTraces) {
+      gen.exportLinkFailuresColumnar(logDir + "link-failures.col");
+    }
+    else {
+      gen.exportLinkFailures(logDir + "link-failures.csv");
+    }
+  }
 
   // Choosing forwarding strategy
   ndn::StrategyChoiceHelper::InstallAll("/data/", "/localhost/nfd/strategy/best-route");
@@ -219,6 +473,9 @@ main(int argc, char* argv[])
   pushConsumerHelper.SetAttribute("PIRefreshInterval", StringValue(piRefreshFrequency));
   // Disable probing for all other Forwarding Strategies
   pushConsumerHelper.SetAttribute("ProbeFrequency", StringValue("0"));
+  pushConsumerHelper.SetAttribute("JitterBuffer", StringValue(jitterBuffer));
+  pushConsumerHelper.SetAttribute("AdaptiveJitterBuffer", BooleanValue(adaptiveJitterBuffer));
+  pushConsumerHelper.SetAttribute("FrameFrequency", StringValue("100"));
 
   ns3::ndn::AppHelper voipProducerHelper ("ns3::ndn::VoIPProducer"); // Callee for prerequest and standard approach
   voipProducerHelper.SetAttribute ("PayloadSize", StringValue("82"));
@@ -228,6 +485,8 @@ main(int argc, char* argv[])
   callerHelper.SetAttribute ("Frequency", StringValue ("100"));
   callerHelper.SetAttribute ("Randomize", StringValue ("none"));
   callerHelper.SetAttribute ("LifeTime", StringValue("1.00s"));
+  callerHelper.SetAttribute ("JitterBuffer", StringValue(jitterBuffer));
+  callerHelper.SetAttribute ("AdaptiveJitterBuffer", BooleanValue(adaptiveJitterBuffer));
   if (approach.compare("prerequest") == 0) {
     callerHelper.SetAttribute ("LookaheadLiftime", IntegerValue(250)); //250ms
   } else if (approach.compare("standard") == 0) {
@@ -247,51 +506,56 @@ main(int argc, char* argv[])
       std::string callerPrefix = "/voip/" + boost::lexical_cast<std::string>(boost::lexical_cast<std::string>(caller->GetId()));
       std::string calleePrefix = "/voip/" + boost::lexical_cast<std::string>(callee->GetId());
 
-      ndnGlobalRoutingHelper.AddOrigins(callerPrefix, caller);
-      ndnGlobalRoutingHelper.AddOrigins(calleePrefix, callee);
-
       uint32_t arrival = startingTimes[i];
       uint32_t end = arrival + callLengths[i];
       std::cout << "Call from node " << caller->GetId() << " to " << callee->GetId() << " starts at " << arrival << " (length=" << callLengths[i] << ")" << std::endl;
 
+      // applications only run on the rank of their node
       if (approach.compare("push") == 0) {
-        // Install producer on caller-side
-        pushProducerHelper.SetPrefix(callerPrefix + appSuffix);
-        ApplicationContainer consumer = pushProducerHelper.Install(caller);
-        // Install consumer on caller-side
-        pushConsumerHelper.SetPrefix(calleePrefix + appSuffix);
-        consumer = pushConsumerHelper.Install(caller);
-        consumer.Start(MilliSeconds(arrival));
-        consumer.Stop(MilliSeconds(end));
-
-        // Install producer on callee-side
-        pushProducerHelper.SetPrefix(calleePrefix + appSuffix);
-        consumer = pushProducerHelper.Install(callee);
-        // Install consumer on callee-side
-        pushConsumerHelper.SetPrefix(callerPrefix + appSuffix);
-        consumer = pushConsumerHelper.Install (callee);
-        consumer.Start(MilliSeconds(arrival));
-        consumer.Stop(MilliSeconds(end));
+        if (ndn::MpiPartition::IsLocal(caller)) {
+          // Install producer on caller-side
+          pushProducerHelper.SetPrefix(callerPrefix + appSuffix);
+          ApplicationContainer consumer = pushProducerHelper.Install(caller);
+          // Install consumer on caller-side
+          pushConsumerHelper.SetPrefix(calleePrefix + appSuffix);
+          consumer = pushConsumerHelper.Install(caller);
+          consumer.Start(MilliSeconds(arrival));
+          consumer.Stop(MilliSeconds(end));
+        }
+
+        if (ndn::MpiPartition::IsLocal(callee)) {
+          // Install producer on callee-side
+          pushProducerHelper.SetPrefix(calleePrefix + appSuffix);
+          ApplicationContainer consumer = pushProducerHelper.Install(callee);
+          // Install consumer on callee-side
+          pushConsumerHelper.SetPrefix(callerPrefix + appSuffix);
+          consumer = pushConsumerHelper.Install (callee);
+          consumer.Start(MilliSeconds(arrival));
+          consumer.Stop(MilliSeconds(end));
+        }
 
       } else {
-
-        // Install producer on caller-side
-        voipProducerHelper.SetPrefix(callerPrefix + appSuffix);
-        voipProducerHelper.Install(caller);
-        // Install consumer on caller-side
-        callerHelper.SetPrefix(calleePrefix + appSuffix);
-        ApplicationContainer consumer = callerHelper.Install (caller);
-        consumer.Start(MilliSeconds(arrival));
-        consumer.Stop(MilliSeconds(end));
-
-        // Install producer on callee-side
-        voipProducerHelper.SetPrefix(calleePrefix + appSuffix);
-        voipProducerHelper.Install(callee);
-        // Install consumer on callee-side
-        callerHelper.SetPrefix(callerPrefix + appSuffix);
-        consumer = callerHelper.Install (callee);
-        consumer.Start(MilliSeconds(arrival));
-        consumer.Stop(MilliSeconds(end));
+        if (ndn::MpiPartition::IsLocal(caller)) {
+          // Install producer on caller-side
+          voipProducerHelper.SetPrefix(callerPrefix + appSuffix);
+          voipProducerHelper.Install(caller);
+          // Install consumer on caller-side
+          callerHelper.SetPrefix(calleePrefix + appSuffix);
+          ApplicationContainer consumer = callerHelper.Install (caller);
+          consumer.Start(MilliSeconds(arrival));
+          consumer.Stop(MilliSeconds(end));
+        }
+
+        if (ndn::MpiPartition::IsLocal(callee)) {
+          // Install producer on callee-side
+          voipProducerHelper.SetPrefix(calleePrefix + appSuffix);
+          voipProducerHelper.Install(callee);
+          // Install consumer on callee-side
+          callerHelper.SetPrefix(callerPrefix + appSuffix);
+          ApplicationContainer consumer = callerHelper.Install (callee);
+          consumer.Start(MilliSeconds(arrival));
+          consumer.Stop(MilliSeconds(end));
+        }
       }
   }
   
@@ -302,8 +566,9 @@ main(int argc, char* argv[])
     Ptr<Node> server = dataServer.Get(i);
     std::string prefix = "/data/" + boost::lexical_cast<std::string>(server->GetId());
     producerHelper.SetPrefix(prefix);
-    producerHelper.Install(server);
-    ndnGlobalRoutingHelper.AddOrigins(prefix, server);
+    if (ndn::MpiPartition::IsLocal(server)) {
+      producerHelper.Install(server);
+    }
   }
 
   // Cross-Traffic Consumer
@@ -316,31 +581,127 @@ main(int argc, char* argv[])
     std::string prefix = "/data/" + boost::lexical_cast<std::string>(server->GetId());
     consumerHelper.SetPrefix(prefix);
 
-    consumerHelper.Install(cl);
+    if (ndn::MpiPartition::IsLocal(cl)) {
+      consumerHelper.Install(cl);
+    }
   }
 
   // 8) Configure Traces
+  // the jitter buffers of push consumers take the send times from the flow statistics
+  bool isPlayoutMeasured = !Time(jitterBuffer).IsZero();
+  ndn::FlowStatistics::getInstance().setEnabled(flowStats || isPlayoutMeasured);
+  std::ofstream countersFile;
+  std::map<std::string, std::shared_ptr<ndn::TraceSink>> traceSinks;
+  std::list<Ptr<L2RateTracer>> l2RateTracers;
+  bool isAsyncTracing = asyncTraces != "off";
+  auto openSink = [&] (const std::string& file) {
+    ndn::TraceSink::Mode mode = asyncTraces == "drop" ? ndn::TraceSink::ASYNC_DROP :
+                                asyncTraces == "block" ? ndn::TraceSink::ASYNC_BLOCK : ndn::TraceSink::SYNCHRONOUS;
+    std::shared_ptr<ndn::TraceSink> sink = ndn::TraceSink::open(file, mode);
+    if (sink == nullptr) {
+      NS_FATAL_ERROR("File " << file << " cannot be opened for writing");
+    }
+    traceSinks[file] = sink;
+    return sink;
+  };
   if (skipLogging.compare("false") == 0) {
+    if (!traceFilter.empty()) {
+      std::map<std::string, NodeContainer> nodeSets = {{"core", gen.getAllASNodes()},
+                                                       {"leaf", gen.getAllLeafNodes()},
+                                                       {"Callee", server},
+                                                       {"Client", client},
+                                                       {"DataServer", dataServer},
+                                                       {"DataClient", dataClient}};
+      auto filter = ndn::TraceFilter::compile(traceFilter, nodeSets);
+      ndn::L3PacketTracer::SetFilter(filter);
+      ndn::PushTracer::SetFilter(filter);
+    }
+
     NodeContainer pushParticipants;
-    pushParticipants.Add(server);
-    pushParticipants.Add(client);
-    ns3::ndn::PushTracer::Install(pushParticipants, std::string(logDir + "push-trace.txt"));
-    ndn::L3RateTracer::Install(pushParticipants, std::string(logDir + "push-rate-trace.txt"), Seconds(600.0));
-    ndn::L3PacketTracer::InstallAll(std::string(logDir + "packet-trace.txt"));
-    L2RateTracer::InstallAll("drop-trace.txt", Seconds(1));
+    pushParticipants.Add(ndn::MpiPartition::GetLocalNodes(server));
+    pushParticipants.Add(ndn::MpiPartition::GetLocalNodes(client));
+    if (aggregatePushTrace) {
+      ns3::ndn::PushTracer::InstallAggregated(pushParticipants, logFile("push-trace.txt"));
+    }
+    else if (columnarTraces) {
+      ns3::ndn::PushTracer::InstallColumnar(pushParticipants, logFile("push-trace.col"));
+    }
+    else if (isAsyncTracing) {
+      ns3::ndn::PushTracer::Install(pushParticipants, openSink(logFile("push-trace.txt")));
+    }
+    else {
+      ns3::ndn::PushTracer::Install(pushParticipants, logFile("push-trace.txt"));
+    }
+    ndn::L3RateTracer::Install(pushParticipants, logFile("push-rate-trace.txt"), Seconds(600.0));
+    if (binaryTrace) {
+      ndn::L3PacketTracer::InstallAllBinary(logFile("packet-trace.bin"));
+    }
+    else if (columnarTraces) {
+      ndn::L3PacketTracer::InstallAllColumnar(logFile("packet-trace.col"));
+    }
+    else if (isAsyncTracing) {
+      ndn::L3PacketTracer::InstallAll(openSink(logFile("packet-trace.txt")));
+    }
+    else {
+      ndn::L3PacketTracer::InstallAll(logFile("packet-trace.txt"));
+    }
+    if (isAsyncTracing || systemCount > 1) {
+      l2RateTracers = installL2RateTracers(openSink(ndn::MpiPartition::GetLocalFileName("drop-trace.txt")), Seconds(1));
+    }
+    else {
+      L2RateTracer::InstallAll("drop-trace.txt", Seconds(1));
+    }
+
+    countersFile.open(logFile("forwarder-counters.txt"));
+    countersFile << "Time\tNode\tInInterests\tOutInterests\tInData\tOutData"
+                 << "\tLoopingDrops\tWindowMisses\tDuplicateDeliveries\n";
+    Ptr<ndn::ForwarderCountersTracer> countersTracer =
+      ndn::ForwarderCountersTracer::Install(ndn::MpiPartition::GetLocalNodes(NodeContainer::GetGlobal()), Seconds(1.0));
+    countersTracer->TraceConnectWithoutContext("ForwarderCounters",
+                                               MakeBoundCallback(&writeForwarderCounters, &countersFile));
   }
 
-
-  // Calculate and install FIBs
-  //ndn::GlobalRoutingHelper::CalculateRoutes();
-  ns3::ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes (); 
+  if (systemCount > 1) {
+    // DistributedSimulatorImpl derives the same lookahead from the links between ranks
+    Time lookahead = ndn::MpiPartition::GetLookahead();
+    if (lookahead.IsZero()) {
+      NS_FATAL_ERROR("Links without delay between MPI ranks");
+    }
+    std::cout << "Lookahead: " << lookahead.GetMilliSeconds() << " ms" << std::endl;
+  }
 
   std::cout << "Start" << std::endl;
 
   Simulator::Stop(MilliSeconds(simTime));
 
   Simulator::Run();
+  NodeContainer localNodes = ndn::MpiPartition::GetLocalNodes(NodeContainer::GetGlobal());
+  printNonceMemory(localNodes);
+  printPushCounters(localNodes);
+  if (flowStats) {
+    std::ofstream flowStatsFile(logFile("flow-stats.txt"));
+    ndn::FlowStatistics::getInstance().print(flowStatsFile);
+  }
+  if (isPlayoutMeasured) {
+    std::ofstream playoutStatsFile(logFile("playout-stats.txt"));
+    ndn::FixedJitterBuffer::printAll(playoutStatsFile);
+  }
   Simulator::Destroy();
+  ndn::L3PacketTracer::Destroy();
+  ndn::PushTracer::Destroy();
+  ndn::ForwarderCountersTracer::Destroy();
+  l2RateTracers.clear();
+
+  // the tracers are gone, so their streams have handed the last batches to the sinks
+  for (const auto& sink : traceSinks) {
+    sink.second->flush();
+    const ndn::TraceSink::Stats& stats = sink.second->getStats();
+    std::cout << sink.first << ": " << stats.nBytes / 1024 << " KiB in " << stats.nBatches
+              << " batches, " << stats.nStalls << " stalls, " << stats.nDroppedBatches
+              << " batches (" << stats.nDroppedBytes / 1024 << " KiB) dropped" << std::endl;
+  }
+
+  ndn::MpiPartition::Disable();
 
   std::cout << "Simulation completed" << std::endl;
 
@@ -5,12 +5,47 @@
 #include "ns3/ndnSIM-module.h"
 #include "ns3/ndnSIM/helper/ndn-link-control-helper.hpp"
 
+#include "fw/forwarder.hpp"
+
+#include <chrono>
+#include <iostream>
+
 namespace ns3 {
 
+/**
+ * Sums up the Nack counters of the forwarders of all nodes
+ */
+void
+printNackCounters(const NodeContainer& nodes)
+{
+  uint64_t inNacks = 0;
+  uint64_t outNacks = 0;
+  uint64_t inInterests = 0;
+  for (NodeContainer::Iterator node = nodes.Begin(); node != nodes.End(); ++node) {
+    const nfd::ForwarderCounters& counters =
+      (*node)->GetObject<ndn::L3Protocol>()->getForwarder()->getCounters();
+    inNacks += counters.nInNacks;
+    outNacks += counters.nOutNacks;
+    inInterests += counters.nInInterests;
+  }
+  std::cout << "InInterests: " << inInterests << std::endl;
+  std::cout << "InNacks: " << inNacks << std::endl;
+  std::cout << "OutNacks: " << outNacks << std::endl;
+}
+
 int
 main(int argc, char* argv[])
 {
+  // Loop storm benchmark: every node forwards the Interests on all of its links,
+  // so every Interest circles the topology and triggers DUPLICATE Nacks at every hop.
+  bool loopStorm = false;
+  std::string frequency = "100";
+  double simTime = 20.0;
+
   CommandLine cmd;
+  cmd.AddValue("loopStorm", "Flood Interests on all links without a producer", loopStorm);
+  cmd.AddValue("frequency", "Interests per second of the consumer", frequency);
+  cmd.AddValue("simTime", "Simulated time in seconds", simTime);
   cmd.Parse(argc, argv);
 
   AnnotatedTopologyReader topologyReader("", 25);
@@ -40,26 +75,43 @@ main(int argc, char* argv[])
 
   ndn::AppHelper consumerHelper("ns3::ndn::ConsumerCbr");
   consumerHelper.SetPrefix(prefix);
-  consumerHelper.SetAttribute("Frequency", StringValue("100")); // 100 interests a second
+  consumerHelper.SetAttribute("Frequency", StringValue(frequency)); // 100 interests a second
   consumerHelper.Install(consumerNodes);
 
-  ndn::AppHelper producerHelper("ns3::ndn::Producer");
-  producerHelper.SetPrefix(prefix);
-  producerHelper.SetAttribute("PayloadSize", StringValue("1024"));
-  producerHelper.Install(producer);
-
-  // Add /prefix origins to ndn::GlobalRouter
-  ndnGlobalRoutingHelper.AddOrigins(prefix, producer);
-
-  // Calculate and install FIBs
-  ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes();
-
-  // Simulator::Schedule(Seconds(5.0), ndn::LinkControlHelper::FailLink, 
+  if (loopStorm) {
+    // routes over every link in both directions, nobody answers the Interests
+    for (const TopologyReader::Link& link : topologyReader.GetLinks()) {
+      ndn::FibHelper::AddRoute(link.GetFromNode(), prefix, link.GetToNode(), 1);
+      ndn::FibHelper::AddRoute(link.GetToNode(), prefix, link.GetFromNode(), 1);
+    }
+  }
+  else {
+    ndn::AppHelper producerHelper("ns3::ndn::Producer");
+    producerHelper.SetPrefix(prefix);
+    producerHelper.SetAttribute("PayloadSize", StringValue("1024"));
+    producerHelper.Install(producer);
+
+    // Add /prefix origins to ndn::GlobalRouter
+    ndnGlobalRoutingHelper.AddOrigins(prefix, producer);
+
+    // Calculate and install FIBs
+    ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes();
+  }
+
+  // Simulator::Schedule(Seconds(5.0), ndn::LinkControlHelper::FailLink,
   // Names::Find<Node>("NodeB"), Names::Find<Node>("Prod1"));
 
-  Simulator::Stop(Seconds(20.0));
+  Simulator::Stop(Seconds(simTime));
 
+  auto start = std::chrono::steady_clock::now();
   Simulator::Run();
+  auto wallTime = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start);
+
+  std::cout << "Wall time: " << wallTime.count() << " ms for " << simTime << " s simulated"
+            << std::endl;
+  printNackCounters(NodeContainer::GetGlobal());
+
   Simulator::Destroy();
 
   return 0;
@@ -71,4 +123,4 @@ int
 main(int argc, char* argv[])
 {
   return ns3::main(argc, argv);
-}
\ No newline at end of file
+}
@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// topology-generation.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+
+#include "../extensions/randnetworks/networkgenerator.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+namespace ns3 {
+
+/**
+ * Benchmark of the topology setup of the bitvector-length and voip-topo scenarios on a
+ * large BRITE topology (brite_configs/brite_5k.conf: 50 AS with 100 routers each).
+ *
+ * Runs the same NetworkGenerator steps as the scenarios, without installing the NDN stack
+ * or running the simulation, and prints the wall time of every step. With an existing
+ * --topologySnapshot, only the time to load the snapshot is measured.
+ *
+ *     ./waf --run "topology-generation --briteConfig=brite_configs/brite_5k.conf"
+ */
+
+class StepTimer
+{
+public:
+  StepTimer()
+    : m_start(std::chrono::steady_clock::now())
+  {
+  }
+
+  void
+  print(const std::string& step)
+  {
+    auto now = std::chrono::steady_clock::now();
+    std::cout << step << ": "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(now - m_start).count()
+              << " ms" << std::endl;
+    m_start = now;
+  }
+
+private:
+  std::chrono::steady_clock::time_point m_start;
+};
+
+int
+main(int argc, char* argv[])
+{
+  std::string confFile = "brite_configs/brite_5k.conf";
+  std::string queue = "DropTail_Bytes";
+  int interAsConnections = -1;   // default: number of AS, as in the scenarios
+  int intraAsConnections = -1;   // default: half the routers of an AS
+  uint32_t placedNodes = 1000;
+  uint32_t linkFailures = 100;
+  std::string exportFile = "";
+  std::string topologySnapshot = "";
+
+  CommandLine cmd;
+  cmd.AddValue("briteConfig", "Brite-config file", confFile);
+  cmd.AddValue("queueName", "Name of the queue to use", queue);
+  cmd.AddValue("interAsConnections", "Random connections between two AS", interAsConnections);
+  cmd.AddValue("intraAsConnections", "Random connections within every AS", intraAsConnections);
+  cmd.AddValue("placedNodes", "Callees and clients placed at leaf nodes (each)", placedNodes);
+  cmd.AddValue("linkFailures", "Number of random link failures", linkFailures);
+  cmd.AddValue("exportTopology", "Write the topology to this file", exportFile);
+  cmd.AddValue("topologySnapshot", "Load the topology from this snapshot if it exists, "
+               "otherwise save the generated one there", topologySnapshot);
+  cmd.Parse(argc, argv);
+
+  StepTimer timer;
+  auto start = std::chrono::steady_clock::now();
+
+  if (!topologySnapshot.empty() && std::ifstream(topologySnapshot.c_str()).good()) {
+    std::unique_ptr<ndn::NetworkGenerator> gen(ndn::NetworkGenerator::fromSnapshot(topologySnapshot));
+    timer.print("Snapshot (" + std::to_string(NodeList::GetNNodes()) + " nodes, "
+                + std::to_string(gen->getNumberOfAS()) + " AS)");
+
+    Simulator::Destroy();
+    return 0;
+  }
+
+  ndn::NetworkGenerator gen(confFile, queue, 50);
+  timer.print("BRITE topology (" + std::to_string(gen.getAllASNodes().size()) + " nodes, "
+              + std::to_string(gen.getNumberOfAS()) + " AS)");
+
+  if (interAsConnections < 0) {
+    interAsConnections = gen.getNumberOfAS();
+  }
+  if (intraAsConnections < 0) {
+    intraAsConnections = gen.getAllASNodesFromAS(0).size() / 2;
+  }
+
+  gen.randomlyAddConnectionsBetweenTwoAS(interAsConnections, 3000, 5000, 5, 20);
+  timer.print("Connections between AS (" + std::to_string(interAsConnections) + ")");
+
+  gen.randomlyAddConnectionsBetweenTwoNodesPerAS(intraAsConnections, 500, 1500, 5, 20);
+  timer.print("Connections within AS (" + std::to_string(intraAsConnections) + " per AS)");
+
+  PointToPointHelper p2p;
+  p2p.SetChannelAttribute("Delay", StringValue("2ms"));
+  p2p.SetDeviceAttribute("DataRate", StringValue("1Mbps"));
+  gen.randomlyPlaceNodes(placedNodes, "Callee", ndn::NetworkGenerator::LeafNode, &p2p);
+  gen.randomlyPlaceNodes(placedNodes, "Client", ndn::NetworkGenerator::LeafNode, &p2p);
+  timer.print("Placed nodes (" + std::to_string(2 * placedNodes) + ")");
+
+  for (uint32_t i = 0; i < linkFailures; i++) {
+    gen.creatRandomLinkFailure(0, 600000, 120000, 180000);
+  }
+  timer.print("Link failures (" + std::to_string(linkFailures) + ")");
+
+  std::cout << "Connectivity: " << gen.calculateConnectivity() << std::endl;
+  timer.print("Connectivity");
+
+  if (!exportFile.empty()) {
+    gen.exportTopology(exportFile, "Callee", "Client");
+    timer.print("Export");
+  }
+
+  if (!topologySnapshot.empty()) {
+    gen.exportSnapshot(topologySnapshot);
+    timer.print("Snapshot export");
+  }
+
+  std::cout << "Total: "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(
+                 std::chrono::steady_clock::now() - start).count()
+            << " ms" << std::endl;
+
+  Simulator::Destroy();
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+// voip-long-call.cpp
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "../extensions/apps/voip-client.hpp"
+
+#include <unistd.h>
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace ns3 {
+
+/**
+ * Long-call regression benchmark of the VoipClient partner state.
+ *
+ *      +----------+     1Mbps      +--------+     1Mbps      +----------+
+ *      |  Caller  | <------------> | Router | <------------> |  Callee  |
+ *      +----------+         10ms   +--------+          10ms  +----------+
+ *
+ * The caller knows the callee from its configuration, the callee learns the caller from
+ * the first Persistent Interest. Both refresh their Persistent Interest every
+ * PIRefreshInterval while Data flows in both directions for the whole call.
+ *
+ * Every period, the Interests sent by each client, the size of their partner tables and
+ * the resident set size of the process are printed. Without a regression, all of them
+ * stay constant over the call. The scenario fails if the Interest rate or the number of
+ * partners of any later period exceeds the one of the first period.
+ *
+ *     ./waf --run "voip-long-call --callDuration=3600 --period=60"
+ */
+
+struct ClientSample
+{
+  Ptr<ndn::VoipClient> client;
+  uint64_t nInterests = 0;     ///< Interests sent in the current period
+  uint64_t nFirstInterests = 0;
+  size_t nFirstPartners = 0;
+  bool isRegression = false;
+};
+
+void
+countInterest(ClientSample* sample, shared_ptr<const ndn::Interest>, Ptr<ndn::App>,
+              shared_ptr<ndn::Face>)
+{
+  sample->nInterests++;
+}
+
+/**
+ * Resident set size of the simulation in KiB
+ */
+uint64_t
+getResidentSetSize()
+{
+  uint64_t size = 0;
+  uint64_t resident = 0;
+  std::ifstream statm("/proc/self/statm");
+  statm >> size >> resident;
+  return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+void
+printSample(std::vector<ClientSample>* samples, Time period, bool isFirst)
+{
+  std::cout << std::setw(8) << Simulator::Now().GetSeconds();
+  for (ClientSample& sample : *samples) {
+    size_t nPartners = sample.client->GetNumCommunicationPartners();
+    std::cout << "\t" << sample.nInterests << "\t" << nPartners;
+
+    if (isFirst) {
+      sample.nFirstInterests = sample.nInterests;
+      sample.nFirstPartners = nPartners;
+    }
+    else {
+      // one refresh of slack for the phase of the refresh timer
+      sample.isRegression = sample.isRegression || sample.nInterests > sample.nFirstInterests + 1
+                            || nPartners > sample.nFirstPartners;
+    }
+    sample.nInterests = 0;
+  }
+  std::cout << "\t" << getResidentSetSize() << std::endl;
+
+  Simulator::Schedule(period, &printSample, samples, period, false);
+}
+
+int
+main(int argc, char* argv[])
+{
+  double callDuration = 3600.0;
+  double period = 60.0;
+  std::string piRefreshInterval = "2s";
+
+  CommandLine cmd;
+  cmd.AddValue("callDuration", "Length of the call in seconds", callDuration);
+  cmd.AddValue("period", "Sampling period in seconds", period);
+  cmd.AddValue("piRefreshInterval", "Refresh interval of the Persistent Interests", piRefreshInterval);
+  cmd.Parse(argc, argv);
+
+  Config::SetDefault("ns3::PointToPointNetDevice::DataRate", StringValue("1Mbps"));
+  Config::SetDefault("ns3::PointToPointChannel::Delay", StringValue("10ms"));
+
+  NodeContainer nodes;
+  nodes.Create(3);
+  Names::Add("Caller", nodes.Get(0));
+  Names::Add("Router", nodes.Get(1));
+  Names::Add("Callee", nodes.Get(2));
+
+  PointToPointHelper p2p;
+  p2p.Install(nodes.Get(0), nodes.Get(1));
+  p2p.Install(nodes.Get(1), nodes.Get(2));
+
+  ndn::StackHelper ndnHelper;
+  ndnHelper.InstallAll();
+
+  ndn::StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/best-route");
+
+  ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
+  ndnGlobalRoutingHelper.InstallAll();
+
+  std::string callerPrefix = "/voip/caller";
+  std::string calleePrefix = "/voip/callee";
+
+  ndn::AppHelper clientHelper("ns3::ndn::VoipClient");
+  clientHelper.SetAttribute("LifeTime", StringValue("5s"));
+  clientHelper.SetAttribute("PIRefreshInterval", StringValue(piRefreshInterval));
+  clientHelper.SetAttribute("DataFrequency", StringValue("100"));
+
+  clientHelper.SetPrefix(callerPrefix);
+  clientHelper.SetAttribute("Name", StringValue(callerPrefix));
+  clientHelper.SetAttribute("AddCommunicationPartner", StringValue(calleePrefix));
+  ApplicationContainer apps = clientHelper.Install(nodes.Get(0));
+
+  clientHelper.SetPrefix(calleePrefix);
+  clientHelper.SetAttribute("Name", StringValue(calleePrefix));
+  clientHelper.SetAttribute("AddCommunicationPartner", StringValue(""));
+  apps.Add(clientHelper.Install(nodes.Get(2)));
+
+  apps.Stop(Seconds(callDuration));
+
+  ndnGlobalRoutingHelper.AddOrigins(callerPrefix, nodes.Get(0));
+  ndnGlobalRoutingHelper.AddOrigins(calleePrefix, nodes.Get(2));
+  ndn::GlobalRoutingHelper::CalculateRoutes();
+
+  std::vector<ClientSample> samples(apps.GetN());
+  for (uint32_t i = 0; i < apps.GetN(); i++) {
+    samples[i].client = DynamicCast<ndn::VoipClient>(apps.Get(i));
+    samples[i].client->TraceConnectWithoutContext("TransmittedInterests",
+                                                  MakeBoundCallback(&countInterest, &samples[i]));
+  }
+
+  std::cout << "    Time\tCallerInterests\tCallerPartners\tCalleeInterests\tCalleePartners\tRssKiB"
+            << std::endl;
+  Simulator::Schedule(Seconds(period), &printSample, &samples, Seconds(period), true);
+
+  Simulator::Stop(Seconds(callDuration));
+  Simulator::Run();
+  Simulator::Destroy();
+
+  bool isRegression = false;
+  for (const ClientSample& sample : samples) {
+    isRegression = isRegression || sample.isRegression;
+  }
+  if (isRegression) {
+    std::cout << "Interest rate or partner table grew during the call" << std::endl;
+    return 1;
+  }
+  std::cout << "Interest rate and partner tables constant" << std::endl;
+  return 0;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
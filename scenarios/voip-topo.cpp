@@ -29,11 +29,15 @@
 #include "../extensions/randnetworks/networkgenerator.h"
 
 #include "../extensions/utils/parameterconfiguration.h"
+#include "../extensions/utils/parallel-routing-helper.hpp"
+#include "../extensions/utils/replications.hpp"
 #include "../extensions/strategies/lowest-cost-strategy.hpp"
 
 #include "../extensions/tracers/push-tracer.hpp"
 #include "../extensions/tracers/ndn-l3-packet-tracer.hpp"
 
+#include <fstream>
+#include <memory>
 #include <sstream>
 
 namespace ns3 {
@@ -78,6 +82,11 @@ main(int argc, char* argv[])
   std::string piRefreshFrequency = "2s";
   std::string linkErrorParam = "0";
   std::string skipLogging = "false";
+  std::string topologySnapshot = "";
+  std::string routeCache = "";
+  std::string failureSchedule = "";
+  uint32_t replications = 1;
+  uint32_t replicationJobs = 0;
 
   // Read Commandline Parameters
   CommandLine cmd;
@@ -89,6 +98,15 @@ main(int argc, char* argv[])
   cmd.AddValue("piRefreshFrequency", "Number of Refresh Persistent Interests per Second", piRefreshFrequency);
   cmd.AddValue("linkErrors", "Number of link errors during simulation", linkErrorParam);
   cmd.AddValue("skipLogging", "No logging when parameter is true", skipLogging);
+  cmd.AddValue("topologySnapshot", "Load topology, placed nodes and link failures from this snapshot if it exists, "
+               "otherwise generate them and save them there. A loaded snapshot keeps its link failures, "
+               "linkErrors and failureSchedule are then ignored", topologySnapshot);
+  cmd.AddValue("routeCache", "Directory where the calculated routes are cached per topology", routeCache);
+  cmd.AddValue("failureSchedule", "Add the link failures of the failure processes in this file (times in ms)",
+               failureSchedule);
+  cmd.AddValue("replications", "Fork this many replications with the runs RngRun, RngRun+1, ... after building "
+               "the topology, each writes to <logDir>run-<run>/", replications);
+  cmd.AddValue("replicationJobs", "Replications running at the same time (0=number of cores)", replicationJobs);
   cmd.Parse(argc, argv);
 
   std::string appSuffix = "/app";
@@ -117,8 +135,21 @@ main(int argc, char* argv[])
   std::cout << "Link errors: " << linkErrors << std::endl;
   std::cout << std::endl;
 
-  // 1) Parse Brite-Config and generate network with BRITE
-  ns3::ndn::NetworkGenerator gen(confFile, queue, 50);
+  // 1) Parse Brite-Config and generate network with BRITE, or load a previously generated one
+  bool isSnapshotLoaded = !topologySnapshot.empty() && std::ifstream(topologySnapshot.c_str()).good();
+  std::unique_ptr<ns3::ndn::NetworkGenerator> generator;
+  if (isSnapshotLoaded) {
+    std::cout << "Loading topology snapshot " << topologySnapshot << std::endl;
+    if (linkErrors != 0 || !failureSchedule.empty()) {
+      std::cout << "Warning: linkErrors and failureSchedule are ignored, the link failures of the "
+                << "snapshot are used" << std::endl;
+    }
+    generator.reset(ns3::ndn::NetworkGenerator::fromSnapshot(topologySnapshot));
+  }
+  else {
+    generator.reset(new ns3::ndn::NetworkGenerator(confFile, queue, 50));
+  }
+  ns3::ndn::NetworkGenerator& gen = *generator;
 
   uint32_t simTime = 10 * 60* 1000; // Simtime in milliseconds (10 minutes)
   uint32_t avgCallDuration = 150000; // http://www.bundesnetzagentur.de/SharedDocs/Pressemitteilungen/DE/2011/110728DauerHandygespraeche.html
@@ -130,39 +161,41 @@ main(int argc, char* argv[])
   int additional_random_connections_as = -1;
   int additional_random_connections_leaf = - 1;
 
-  // Config for Medium connectivity from example.cc
-  min_bw_as = 3000;
-  max_bw_as = 5000;
+  if (!isSnapshotLoaded) {
+    // Config for Medium connectivity from example.cc
+    min_bw_as = 3000;
+    max_bw_as = 5000;
 
-  min_bw_leaf = 500;
-  max_bw_leaf = 1500;
+    min_bw_leaf = 500;
+    max_bw_leaf = 1500;
 
-  //
-  additional_random_connections_as = gen.getNumberOfAS ();
-  additional_random_connections_leaf = gen.getAllASNodesFromAS (0).size () / 2;
+    //
+    additional_random_connections_as = gen.getNumberOfAS ();
+    additional_random_connections_leaf = gen.getAllASNodesFromAS (0).size () / 2;
 
-  // Add random connections between nodes
-  gen.randomlyAddConnectionsBetweenTwoAS (additional_random_connections_as,min_bw_as,max_bw_as,5,20);
-  gen.randomlyAddConnectionsBetweenTwoNodesPerAS(additional_random_connections_leaf,min_bw_leaf,max_bw_leaf,5,20);
+    // Add random connections between nodes
+    gen.randomlyAddConnectionsBetweenTwoAS (additional_random_connections_as,min_bw_as,max_bw_as,5,20);
+    gen.randomlyAddConnectionsBetweenTwoNodesPerAS(additional_random_connections_leaf,min_bw_leaf,max_bw_leaf,5,20);
 
-  //NodeContainer routers = gen.getAllASNodes ();
-  //ns3::ndn::CsTracer::Install(routers, std::string(outputFolder + "/cs-trace.txt"), Seconds(1.0));
+    //NodeContainer routers = gen.getAllASNodes ();
+    //ns3::ndn::CsTracer::Install(routers, std::string(outputFolder + "/cs-trace.txt"), Seconds(1.0));
 
 
-  // 2) Create Callees, Callers, and cross-traffic clients/server
-  PointToPointHelper *p2p = new PointToPointHelper;
-  p2p->SetChannelAttribute ("Delay", StringValue ("2ms"));
+    // 2) Create Callees, Callers, and cross-traffic clients/server
+    PointToPointHelper *p2p = new PointToPointHelper;
+    p2p->SetChannelAttribute ("Delay", StringValue ("2ms"));
 
-  p2p->SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
-  gen.randomlyPlaceNodes (20, "Callee",ns3::ndn::NetworkGenerator::LeafNode, p2p);
+    p2p->SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+    gen.randomlyPlaceNodes (20, "Callee",ns3::ndn::NetworkGenerator::LeafNode, p2p);
 
-  p2p->SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
-  gen.randomlyPlaceNodes (20, "Client",ns3::ndn::NetworkGenerator::LeafNode, p2p);
+    p2p->SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+    gen.randomlyPlaceNodes (20, "Client",ns3::ndn::NetworkGenerator::LeafNode, p2p);
 
-  p2p->SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
-  gen.randomlyPlaceNodes (4, "DataServer",ns3::ndn::NetworkGenerator::LeafNode, p2p);
-  p2p->SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
-  gen.randomlyPlaceNodes (4, "DataClient",ns3::ndn::NetworkGenerator::LeafNode, p2p);
+    p2p->SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+    gen.randomlyPlaceNodes (4, "DataServer",ns3::ndn::NetworkGenerator::LeafNode, p2p);
+    p2p->SetDeviceAttribute ("DataRate", StringValue ("1Mbps"));
+    gen.randomlyPlaceNodes (4, "DataClient",ns3::ndn::NetworkGenerator::LeafNode, p2p);
+  }
 
 
   // 3) Install NDN Stack on all nodes
@@ -184,6 +217,35 @@ main(int argc, char* argv[])
   ns3::ndn::GlobalRoutingHelper ndnGlobalRoutingHelper;
   ndnGlobalRoutingHelper.InstallAll ();
 
+  // the prefixes only depend on the placed nodes, not on the calls
+  for (uint i = 0; i < client.size(); i++) {
+    Ptr<Node> caller = Names::Find<Node>(std::string("Client_" + boost::lexical_cast<std::string>(i)));
+    Ptr<Node> callee = server.Get(i);
+    ndnGlobalRoutingHelper.AddOrigins("/voip/" + boost::lexical_cast<std::string>(caller->GetId()), caller);
+    ndnGlobalRoutingHelper.AddOrigins("/voip/" + boost::lexical_cast<std::string>(callee->GetId()), callee);
+  }
+  for (uint i = 0; i < dataServer.size(); i++) {
+    Ptr<Node> server = dataServer.Get(i);
+    ndnGlobalRoutingHelper.AddOrigins("/data/" + boost::lexical_cast<std::string>(server->GetId()), server);
+  }
+
+  // Calculate and install FIBs
+  //ndn::GlobalRoutingHelper::CalculateRoutes();
+  ns3::ndn::ParallelRoutingHelper::CalculateAllPossibleRoutes (routeCache);
+
+  if (!isSnapshotLoaded) {
+    for(int i = 0; i < linkErrors; i++)
+      gen.creatRandomLinkFailure(0, simTime, avgCallDuration * 0.8, avgCallDuration * 1.2);
+    if (!failureSchedule.empty())
+      gen.loadLinkFailureSchedule(failureSchedule);
+  }
+  if (!topologySnapshot.empty() && !isSnapshotLoaded) {
+    gen.exportSnapshot(topologySnapshot);
+  }
+
+  // everything above is shared by the replications, the calls below are drawn by each of them
+  logDir = ndn::Replications::Fork(replications, replicationJobs, logDir);
+
   Ptr<UniformRandomVariable> arrivalDistribution = CreateObject<UniformRandomVariable>();
   Ptr<UniformRandomVariable> calleeDistribution = CreateObject<UniformRandomVariable>();
   Ptr<NormalRandomVariable> durationDistribution = CreateObject<NormalRandomVariable>();
@@ -210,9 +272,6 @@ main(int argc, char* argv[])
     // std::cout << "Call from node " << caller->GetId() << " to " << callee->GetId() << " starts at " << arrival << " (length=" << callLengths[i] << ")" << std::endl;
   }
   saveCallInfo(logDir + "callInfo.csv", callLog);
-
-  for(int i = 0; i < linkErrors; i++)
-    gen.creatRandomLinkFailure(0, simTime, avgCallDuration * 0.8, avgCallDuration * 1.2);
   gen.exportLinkFailures(logDir + "link-failures.csv");
   
 
@@ -266,9 +325,6 @@ main(int argc, char* argv[])
       std::string callerPrefix = "/voip/" + boost::lexical_cast<std::string>(boost::lexical_cast<std::string>(caller->GetId()));
       std::string calleePrefix = "/voip/" + boost::lexical_cast<std::string>(callee->GetId());
 
-      ndnGlobalRoutingHelper.AddOrigins(callerPrefix, caller);
-      ndnGlobalRoutingHelper.AddOrigins(calleePrefix, callee);
-
       uint32_t arrival = startingTimes[i];
       uint32_t end = arrival + callLengths[i];
       std::cout << "Call from node " << caller->GetId() << " to " << callee->GetId() << " starts at " << arrival << " (length=" << callLengths[i] << ")" << std::endl;
@@ -335,7 +391,6 @@ main(int argc, char* argv[])
     std::string prefix = "/data/" + boost::lexical_cast<std::string>(server->GetId());
     producerHelper.SetPrefix(prefix);
     producerHelper.Install(server);
-    ndnGlobalRoutingHelper.AddOrigins(prefix, server);
   }
 
   // Cross-Traffic Consumer
@@ -367,11 +422,6 @@ main(int argc, char* argv[])
     L2RateTracer::InstallAll("drop-trace.txt", Seconds(1));
   }
 
-
-  // Calculate and install FIBs
-  //ndn::GlobalRoutingHelper::CalculateRoutes();
-  ns3::ndn::GlobalRoutingHelper::CalculateAllPossibleRoutes (); 
-
   std::cout << "Start" << std::endl;
 
   Simulator::Stop(MilliSeconds(simTime));